@@ -1,7 +1,6 @@
 #include <bitset>
 #include <chrono>
 #include <fstream>
-#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -16,6 +15,13 @@
 // in the file. With that in mind, going with option 2
 //
 // There is probably an elegant way to do this...
+//
+// Both ratings are found in a single batched descent (BitCriterion per rating), the
+// streaming reports use one search per rating.
+//
+// Streaming mode: with a second argument K, the tree is filled incrementally and
+// the ratings are reported every K lines (K = 0: only at the end of the stream).
+// Lines starting with '-' remove a value.
 
 namespace {
 
@@ -36,16 +42,31 @@ struct Node {
   Node(int value, std::size_t count = 1);
 
   void addValue(int new_value, int level, std::size_t total);
+
+  // returns false if value was not found
+  bool removeValue(int old_value, int level);
 };
 
 struct BinaryTree {
   BinaryTree(int depth, int root_value);
 
+  //! empty tree, values are streamed in later
+  explicit BinaryTree(int depth);
+
   //! add value to binary tree
   void addValue(int value);
 
-  //! traverse the tree based on selector operation
-  int search(std::function<int(const Node* const node)> selector);
+  //! remove one occurrence of value, returns false if not present
+  bool removeValue(int value);
+
+  //! traverse the tree based on selector policy, which must provide
+  //! bool goLeft(const Node& node, int level) const
+  template <typename Selector>
+  int search(const Selector& selector) const;
+
+  //! evaluate several selectors in a single level-by-level descent
+  template <typename Selector>
+  std::vector<int> search(const std::vector<Selector>& selectors) const;
 
   //! return number of values in tree
   std::size_t size() const;
@@ -56,9 +77,35 @@ struct BinaryTree {
   Node root_;
 };
 
+//! pick child to descend to, never going down an empty subtree
+const Node* descend(const Node& node, bool go_left);
+
 //! Search criteria
-int searchOxygenRating(const Node* const node);
-int searchScrubberRating(const Node* const node);
+struct OxygenRating {
+  // most common bit, 1 if tie
+  bool goLeft(const Node& node, int) const { return node.num_left >= node.num_right; }
+};
+
+struct ScrubberRating {
+  // least common bit, 0 if tie
+  bool goLeft(const Node& node, int) const { return node.num_left < node.num_right; }
+};
+
+//! Runtime configurable criterion, e.g. for batched queries
+//! tie_left_mask : bit i set -> take 1 at level i if both values are equally common
+struct BitCriterion {
+  bool most_common = true;
+  int tie_left_mask = ~0;
+
+  bool goLeft(const Node& node, int level) const {
+    if (node.num_left == node.num_right) return tie_left_mask & (1 << level);
+    return most_common == (node.num_left > node.num_right);
+  }
+};
+
+//! Add / remove values line by line, reporting ratings every report_every lines
+//! and at the end, report_every == 0 only reports at the end
+void streamRatings(std::ifstream& ifile, int depth, std::size_t report_every);
 
 }  // namespace
 
@@ -86,9 +133,14 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  if (argc > 2) {
+    ifile.seekg(0);
+    streamRatings(ifile, N, std::stoul(argv[2]));
+    return 0;
+  }
+
   std::cout << "Root has value " << line << " (" << std::stoi(line, nullptr, 2) << ")" << std::endl;
   BinaryTree tree(N, std::stoi(line, nullptr, 2));
-  int value = 0;
   while (std::getline(ifile, line)) {
     //    std::cout << "------------------------------" << std::endl;
     //    std::cout << "Adding value " << line << " (" << std::stoi(line, nullptr, 2) << ")" <<
@@ -97,8 +149,10 @@ int main(int argc, char** argv) {
   }
   std::cout << "Tree has a total size of " << tree.size() << std::endl;
 
-  int oxygen_rating = tree.search(&searchOxygenRating);
-  int scrubber_rating = tree.search(&searchScrubberRating);
+  // oxygen : most common bit, 1 if tie, scrubber : least common bit, 0 if tie
+  std::vector<int> ratings = tree.search(std::vector<BitCriterion>{{true, ~0}, {false, 0}});
+  int oxygen_rating = ratings[0];
+  int scrubber_rating = ratings[1];
   int life_support_rating = oxygen_rating * scrubber_rating;
   auto t_end = std::chrono::steady_clock::now();
 
@@ -122,7 +176,11 @@ Node::Node(int value, std::size_t count /*= 1*/) : value{value}, counter{count}
 void Node::addValue(int new_value, int level, std::size_t total) {
   // check if leaf
   if (num_left == 0 && num_right == 0) {
-    if (new_value == value) {
+    if (counter == 0) {  // only happens for the root of an empty tree
+      value = new_value;
+      counter = 1;
+      return;
+    } else if (new_value == value) {
       ++counter;
       return;
     } else {  // move content of current node to a child node
@@ -156,34 +214,113 @@ void Node::addValue(int new_value, int level, std::size_t total) {
   }
 }
 
+bool Node::removeValue(int old_value, int level) {
+  // check if leaf
+  if (num_left == 0 && num_right == 0) {
+    if (counter == 0 || old_value != value) return false;
+    if (--counter == 0) value = -1;
+    return true;
+  }
+
+  // drop subtrees that become empty, so that leaves are always the only nodes with values
+  if (goLeft(old_value, level)) {
+    if (num_left == 0 || !left->removeValue(old_value, level - 1)) return false;
+    if (--num_left == 0) left.reset();
+  } else {
+    if (num_right == 0 || !right->removeValue(old_value, level - 1)) return false;
+    if (--num_right == 0) right.reset();
+  }
+  return true;
+}
+
 BinaryTree::BinaryTree(int depth, int root_value) : depth_{depth}, counter_{1}, root_(root_value) {}
 
+BinaryTree::BinaryTree(int depth) : depth_{depth}, counter_{0}, root_(-1, 0) {}
+
 void BinaryTree::addValue(int value) { root_.addValue(value, depth_ - 1, ++counter_); }
 
-int BinaryTree::search(std::function<int(const Node* const node)> selector) {
-  return selector(&root_);
+bool BinaryTree::removeValue(int value) {
+  if (!root_.removeValue(value, depth_ - 1)) return false;
+  --counter_;
+  return true;
 }
 
-std::size_t BinaryTree::size() const { return counter_; }
+template <typename Selector>
+int BinaryTree::search(const Selector& selector) const {
+  if (counter_ == 0) return -1;
 
-int searchOxygenRating(const Node* const node) {
-  if (node->value > -1) return node->value;
+  const Node* node = &root_;
+  for (int level = depth_ - 1; node->value < 0; --level) {
+    node = descend(*node, selector.goLeft(*node, level));
+  }
+  return node->value;
+}
 
-  if (node->num_left >= node->num_right) {
-    return searchOxygenRating(node->left.get());
-  } else {
-    return searchOxygenRating(node->right.get());
+template <typename Selector>
+std::vector<int> BinaryTree::search(const std::vector<Selector>& selectors) const {
+  if (counter_ == 0) return std::vector<int>(selectors.size(), -1);
+
+  std::vector<const Node*> nodes(selectors.size(), &root_);
+
+  // all criteria move down one level together, the upper levels stay in cache
+  bool done = false;
+  for (int level = depth_ - 1; !done; --level) {
+    done = true;
+    for (std::size_t i = 0; i < selectors.size(); ++i) {
+      const Node* node = nodes[i];
+      if (node->value > -1) continue;
+      nodes[i] = descend(*node, selectors[i].goLeft(*node, level));
+      done = false;
+    }
   }
-};
 
-int searchScrubberRating(const Node* const node) {
-  if (node->value > -1) return node->value;
+  std::vector<int> values;
+  values.reserve(nodes.size());
+  for (auto node : nodes) values.push_back(node->value);
+  return values;
+}
 
-  if (node->num_left >= node->num_right) {
-    return searchScrubberRating(node->right.get());
-  } else {
-    return searchScrubberRating(node->left.get());
+std::size_t BinaryTree::size() const { return counter_; }
+
+const Node* descend(const Node& node, bool go_left) {
+  if ((go_left && node.num_left > 0) || node.num_right == 0) return node.left.get();
+  return node.right.get();
+}
+
+void streamRatings(std::ifstream& ifile, int depth, std::size_t report_every) {
+  BinaryTree tree(depth);
+  std::size_t num_lines = 0;
+  std::chrono::nanoseconds update_time{0};
+
+  auto report = [&]() {
+    int oxygen_rating = tree.search(OxygenRating{});
+    int scrubber_rating = tree.search(ScrubberRating{});
+    std::cout << "After " << num_lines << " lines (" << tree.size()
+              << " values): oxygen = " << oxygen_rating << ", scrubber = " << scrubber_rating
+              << ", life support = " << oxygen_rating * scrubber_rating << std::endl;
+  };
+
+  std::string line;
+  while (std::getline(ifile, line)) {
+    if (line.empty()) continue;
+
+    auto t_start = std::chrono::steady_clock::now();
+    if (line[0] == '-') {
+      if (!tree.removeValue(std::stoi(line.substr(1), nullptr, 2))) {
+        std::cout << "Cannot remove " << line.substr(1) << ", not in tree" << std::endl;
+      }
+    } else {
+      tree.addValue(std::stoi(line, nullptr, 2));
+    }
+    update_time += std::chrono::steady_clock::now() - t_start;
+
+    ++num_lines;
+    if (report_every > 0 && num_lines % report_every == 0) report();
   }
-};
+  if (report_every == 0 || num_lines % report_every != 0) report();
+
+  std::cout << "Average update took "
+            << (num_lines > 0 ? update_time.count() / num_lines : 0) << " [ns]" << std::endl;
+}
 
 }  // namespace
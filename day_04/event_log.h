@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+// Event log for the bingo solvers
+//
+// Events are pushed into a single producer / single consumer ring buffer and printed by a
+// background thread, so the timed loops never touch std::cout themselves.
+//
+// Compile with -DBINGO_LOG_LEVEL=<level> to select what gets recorded:
+//
+//   0 : nothing, all logging macros expand to nothing (default)
+//   1 : wins
+//   2 : wins + draws
+//   3 : wins + draws + grid loading
+//
+#define BINGO_LOG_NONE 0
+#define BINGO_LOG_WIN 1
+#define BINGO_LOG_DRAW 2
+#define BINGO_LOG_LOAD 3
+
+#ifndef BINGO_LOG_LEVEL
+#define BINGO_LOG_LEVEL BINGO_LOG_NONE
+#endif
+
+namespace bingo_log {
+
+enum class EventType : std::uint8_t { WIN, DRAW, LOAD };
+
+struct Event {
+  EventType type;
+  int value;
+};
+
+class EventLog {
+ public:
+  EventLog() : writer_([this] { flushLoop(); }) {}
+
+  ~EventLog() {
+    done_.store(true, std::memory_order_release);
+    writer_.join();
+  }
+
+  EventLog(const EventLog&) = delete;
+  EventLog& operator=(const EventLog&) = delete;
+
+  // record event, only waits if the writer is a full buffer behind
+  void push(EventType type, int value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    while (head - tail_.load(std::memory_order_acquire) == CAPACITY) std::this_thread::yield();
+
+    buffer_[head & (CAPACITY - 1)] = {type, value};
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  // wait until everything pushed so far has been printed
+  void flush() const {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    while (tail_.load(std::memory_order_acquire) != head) std::this_thread::yield();
+  }
+
+ private:
+  static constexpr std::size_t CAPACITY = 1 << 16;  // must be a power of 2
+
+  void flushLoop() {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      // read done_ first: everything pushed before the destructor is then visible in head_
+      const bool done = done_.load(std::memory_order_acquire);
+      const std::size_t head = head_.load(std::memory_order_acquire);
+
+      if (tail == head) {
+        if (done) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+
+      for (; tail != head; ++tail) print(buffer_[tail & (CAPACITY - 1)]);
+      std::cout.flush();
+      tail_.store(tail, std::memory_order_release);
+    }
+  }
+
+  static void print(const Event& event) {
+    switch (event.type) {
+      case EventType::WIN:
+        std::cout << "Grid " << event.value << " screams BINGO!\n";
+        break;
+      case EventType::DRAW:
+        std::cout << "Drawing " << event.value << "\n";
+        break;
+      case EventType::LOAD:
+        std::cout << "Filling grid " << event.value << "\n";
+        break;
+    }
+  }
+
+  std::array<Event, CAPACITY> buffer_;
+  alignas(64) std::atomic<std::size_t> head_{0};  // next slot to write, owned by producer
+  alignas(64) std::atomic<std::size_t> tail_{0};  // next slot to print, owned by writer
+  std::atomic<bool> done_{false};
+  std::thread writer_;  // last member, started once everything else is initialized
+};
+
+inline EventLog& eventLog() {
+  static EventLog log;
+  return log;
+}
+
+}  // namespace bingo_log
+
+#if BINGO_LOG_LEVEL >= BINGO_LOG_WIN
+#define BINGO_LOG_WIN_EVENT(grid_id) bingo_log::eventLog().push(bingo_log::EventType::WIN, grid_id)
+#define BINGO_LOG_FLUSH() bingo_log::eventLog().flush()
+#else
+#define BINGO_LOG_WIN_EVENT(grid_id)
+#define BINGO_LOG_FLUSH()
+#endif
+
+#if BINGO_LOG_LEVEL >= BINGO_LOG_DRAW
+#define BINGO_LOG_DRAW_EVENT(value) bingo_log::eventLog().push(bingo_log::EventType::DRAW, value)
+#else
+#define BINGO_LOG_DRAW_EVENT(value)
+#endif
+
+#if BINGO_LOG_LEVEL >= BINGO_LOG_LOAD
+#define BINGO_LOG_LOAD_EVENT(grid_id) \
+  bingo_log::eventLog().push(bingo_log::EventType::LOAD, grid_id)
+#else
+#define BINGO_LOG_LOAD_EVENT(grid_id)
+#endif
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "../event_log.h"
+
 // Assumptions:
 //
 // 1. The same number is never drawn twice
@@ -92,9 +94,10 @@ int main(int argc, char** argv) {
 
   // draw one value at a time
   for (const int& number : sequence) {
-    std::cout << "Drawing " << number << std::endl;
+    BINGO_LOG_DRAW_EVENT(number);
     const Grid* winning_grid = bingo_map.draw(number);
     if (winning_grid != nullptr) {
+      BINGO_LOG_FLUSH();
       std::cout << "Grid " << winning_grid->getId() << " won with a remainder of "
                 << winning_grid->getRemainingSum() << std::endl;
       std::cout << "Total score: " << number * winning_grid->getRemainingSum() << std::endl;
@@ -132,7 +135,7 @@ bool Grid::draw(int row, int col, int value) {
   total_sum_ -= value;
 
   if ((--row_entries_[row] == 0) || (--col_entries_[col] == 0)) {
-    std::cout << "Grid " << id_ << " screams BINGO!" << std::endl;
+    BINGO_LOG_WIN_EVENT(id_);
     return true;
   }
 
@@ -145,7 +148,7 @@ int Grid::getId() const { return id_; }
 
 void BingoMap::loadGrid(std::ifstream& ifile) {
   int grid_id = grids_.size();
-  std::cout << "Filling grid " << grid_id << std::endl;
+  BINGO_LOG_LOAD_EVENT(grid_id);
 
   auto& grid = grids_.emplace_back(grid_id);
 
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "../event_log.h"
+
 // Assumptions:
 //
 // 1. The same number is never drawn twice
@@ -98,9 +100,10 @@ int main(int argc, char** argv) {
   // draw one value at a time
   auto t_start = std::chrono::steady_clock::now();
   for (const int& number : sequence) {
-    std::cout << "Drawing " << number << std::endl;
+    BINGO_LOG_DRAW_EVENT(number);
     const Grid* losing_grid = bingo_map.draw(number);
     if (losing_grid != nullptr) {
+      BINGO_LOG_FLUSH();
       std::cout << "Grid " << losing_grid->getId() << " won last with a remainder of "
                 << losing_grid->getRemainingSum() << std::endl;
       std::cout << "Total score: " << number * losing_grid->getRemainingSum() << std::endl;
@@ -142,7 +145,7 @@ bool Grid::draw(int row, int col, int value) {
   total_sum_ -= value;
 
   if ((--row_entries_[row] == 0) || (--col_entries_[col] == 0)) {
-    std::cout << "Grid " << id_ << " screams BINGO!" << std::endl;
+    BINGO_LOG_WIN_EVENT(id_);
     return true;
   }
 
@@ -155,7 +158,7 @@ int Grid::getId() const { return id_; }
 
 void BingoMap::loadGrid(std::ifstream& ifile) {
   int grid_id = grids_.size();
-  std::cout << "Filling grid " << grid_id << std::endl;
+  BINGO_LOG_LOAD_EVENT(grid_id);
 
   // Given a hint, try_emplace returns iterator to the item pair
   Grid& grid = grids_.try_emplace(grids_.cend(), grid_id, grid_id)->second;
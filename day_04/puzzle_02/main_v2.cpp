@@ -6,14 +6,17 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "../event_log.h"
+
 // Assumptions:
 //
 // 1. The same number is never drawn twice
 // 2. The same number does not appear twice on a grid
-// 3. Grids are 5x5
-// 4. Possible bingo values are 0-99
+// 3. Grids are square, 5x5, 9x9 or 16x16 (detected from the first grid)
+// 4. Bingo values are non-negative ints: 0-99 uses a dense lookup, anything else a hash map
 // 5. Only one board will win at a time
 // 6. Input format is valid
 //
@@ -21,9 +24,47 @@ namespace {
 
 std::vector<int> readBingoNumbers(std::ifstream& ifile);
 
-constexpr int NUM_VALUES = 100;
-constexpr int GRID_SIZE = 5;
+// count values in first grid row, leaves the stream where it was
+int detectGridSize(std::ifstream& ifile);
+
+// load grids and play the sequence for the given grid size and value lookup
+template <int GridSize, typename Lookup>
+int play(std::ifstream& ifile, const std::vector<int>& sequence);
+
+constexpr int NUM_VALUES = 100;  // classic bingo
+
+struct GridLink {
+  GridLink(int row, int col, int id) : row{row}, col{col}, grid_id{id} {}
+  int row;
+  int col;
+  int grid_id;
+};
+
+// value -> grids containing it, for values 0 to NumValues - 1
+template <int NumValues>
+class DenseLookup {
+ public:
+  // values out of range are never drawn, no need to store them
+  void add(int value, const GridLink& link);
+
+  const std::vector<GridLink>* find(int value) const;
 
+ private:
+  std::array<std::vector<GridLink>, NumValues> map_;
+};
+
+// value -> grids containing it, for arbitrary values
+class SparseLookup {
+ public:
+  void add(int value, const GridLink& link);
+
+  const std::vector<GridLink>* find(int value) const;
+
+ private:
+  std::unordered_map<int, std::vector<GridLink>> map_;
+};
+
+template <int GridSize>
 class Grid {
  public:
   Grid(int id);
@@ -42,30 +83,24 @@ class Grid {
 
  private:
   int id_;
-  std::array<int, GRID_SIZE> row_entries_;  // number of entries in each row
-  std::array<int, GRID_SIZE> col_entries_;  // number of entries in each column
+  std::array<int, GridSize> row_entries_;  // number of entries in each row
+  std::array<int, GridSize> col_entries_;  // number of entries in each column
   std::size_t total_sum_ = 0;
   bool has_won_ = false;
 };
 
+template <int GridSize, typename Lookup>
 class BingoMap {
  public:
-  struct GridLink {
-    GridLink(int row, int col, int id) : row{row}, col{col}, grid_id{id} {}
-    int row;
-    int col;
-    int grid_id;
-  };
-
   // load one grid from file
   void loadGrid(std::ifstream& ifile);
 
   // draw next value : if a grid has bingo, return a pointer to it, else nullptr
-  const Grid* draw(int value);
+  const Grid<GridSize>* draw(int value);
 
  private:
-  std::array<std::vector<GridLink>, NUM_VALUES> map_;
-  std::vector<Grid> grids_;
+  Lookup map_;
+  std::vector<Grid<GridSize>> grids_;
   std::size_t players_left_ = 0;
 };
 
@@ -88,8 +123,57 @@ int main(int argc, char** argv) {
   // read first line -> sequence of drawn numbers
   std::vector<int> sequence = readBingoNumbers(ifile);
 
+  // only drawn values are ever looked up, so they decide which lookup to use
+  bool dense = true;
+  for (int value : sequence) dense = dense && (value >= 0) && (value < NUM_VALUES);
+
+  switch (detectGridSize(ifile)) {
+    case 5:
+      return dense ? play<5, DenseLookup<NUM_VALUES>>(ifile, sequence)
+                   : play<5, SparseLookup>(ifile, sequence);
+    case 9:
+      return dense ? play<9, DenseLookup<NUM_VALUES>>(ifile, sequence)
+                   : play<9, SparseLookup>(ifile, sequence);
+    case 16:
+      return dense ? play<16, DenseLookup<NUM_VALUES>>(ifile, sequence)
+                   : play<16, SparseLookup>(ifile, sequence);
+    default:
+      std::cout << "Unsupported grid size" << std::endl;
+      return 1;
+  }
+}
+
+namespace {
+
+std::vector<int> readBingoNumbers(std::ifstream& ifile) {
+  std::vector<int> values;
+  std::string line;
+  std::getline(ifile, line);
+  std::istringstream iss(line);
+
+  std::string value_str;
+  while (std::getline(iss, value_str, ',')) {
+    values.push_back(std::stoi(value_str));
+  }
+
+  return values;
+}
+
+int detectGridSize(std::ifstream& ifile) {
+  auto start = ifile.tellg();
+  std::string line;
+  while (std::getline(ifile, line) && line.find_first_not_of(' ') == std::string::npos) {
+  }
+  ifile.seekg(start);
+
+  std::istringstream iss(line);
+  return std::distance(std::istream_iterator<int>(iss), std::istream_iterator<int>());
+}
+
+template <int GridSize, typename Lookup>
+int play(std::ifstream& ifile, const std::vector<int>& sequence) {
   // load grids
-  BingoMap bingo_map;
+  BingoMap<GridSize, Lookup> bingo_map;
   while (ifile.good()) {
     bingo_map.loadGrid(ifile);
   }
@@ -97,9 +181,10 @@ int main(int argc, char** argv) {
   // draw one value at a time
   auto t_start = std::chrono::steady_clock::now();
   for (const int& number : sequence) {
-    std::cout << "Drawing " << number << std::endl;
-    const Grid* losing_grid = bingo_map.draw(number);
+    BINGO_LOG_DRAW_EVENT(number);
+    const Grid<GridSize>* losing_grid = bingo_map.draw(number);
     if (losing_grid != nullptr) {
+      BINGO_LOG_FLUSH();
       std::cout << "Grid " << losing_grid->getId() << " won last with a remainder of "
                 << losing_grid->getRemainingSum() << std::endl;
       std::cout << "Total score: " << number * losing_grid->getRemainingSum() << std::endl;
@@ -114,36 +199,40 @@ int main(int argc, char** argv) {
   return 0;
 }
 
-namespace {
+template <int NumValues>
+void DenseLookup<NumValues>::add(int value, const GridLink& link) {
+  if (value >= 0 && value < NumValues) map_[value].push_back(link);
+}
 
-std::vector<int> readBingoNumbers(std::ifstream& ifile) {
-  std::vector<int> values;
-  std::string line;
-  std::getline(ifile, line);
-  std::istringstream iss(line);
+template <int NumValues>
+const std::vector<GridLink>* DenseLookup<NumValues>::find(int value) const {
+  return &map_[value];
+}
 
-  std::string value_str;
-  while (std::getline(iss, value_str, ',')) {
-    values.push_back(std::stoi(value_str));
-  }
+void SparseLookup::add(int value, const GridLink& link) { map_[value].push_back(link); }
 
-  return values;
+const std::vector<GridLink>* SparseLookup::find(int value) const {
+  auto it = map_.find(value);
+  return (it != map_.end()) ? &it->second : nullptr;
 }
 
-Grid::Grid(int id) : id_{id} {
-  row_entries_.fill(GRID_SIZE);
-  col_entries_.fill(GRID_SIZE);
+template <int GridSize>
+Grid<GridSize>::Grid(int id) : id_{id} {
+  row_entries_.fill(GridSize);
+  col_entries_.fill(GridSize);
 }
 
-void Grid::add(int value) { total_sum_ += value; }
+template <int GridSize>
+void Grid<GridSize>::add(int value) { total_sum_ += value; }
 
-bool Grid::draw(int row, int col, int value) {
+template <int GridSize>
+bool Grid<GridSize>::draw(int row, int col, int value) {
   if (has_won_) return false;
 
   total_sum_ -= value;
 
   if ((--row_entries_[row] == 0) || (--col_entries_[col] == 0)) {
-    //    std::cout << "Grid " << id_ << " screams BINGO!" << std::endl;
+    BINGO_LOG_WIN_EVENT(id_);
     has_won_ = true;
     return true;
   }
@@ -151,22 +240,25 @@ bool Grid::draw(int row, int col, int value) {
   return false;
 }
 
-std::size_t Grid::getRemainingSum() const { return total_sum_; }
+template <int GridSize>
+std::size_t Grid<GridSize>::getRemainingSum() const { return total_sum_; }
 
-int Grid::getId() const { return id_; }
+template <int GridSize>
+int Grid<GridSize>::getId() const { return id_; }
 
-void BingoMap::loadGrid(std::ifstream& ifile) {
+template <int GridSize, typename Lookup>
+void BingoMap<GridSize, Lookup>::loadGrid(std::ifstream& ifile) {
   int grid_id = grids_.size();
-  std::cout << "Filling grid " << grid_id << std::endl;
+  BINGO_LOG_LOAD_EVENT(grid_id);
 
   auto& grid = grids_.emplace_back(grid_id);
 
   int value;
-  for (int col_idx = 0; col_idx < GRID_SIZE; ++col_idx) {
-    for (int row_idx = 0; row_idx < GRID_SIZE; ++row_idx) {
+  for (int col_idx = 0; col_idx < GridSize; ++col_idx) {
+    for (int row_idx = 0; row_idx < GridSize; ++row_idx) {
       ifile >> value;
       grid.add(value);
-      map_[value].emplace_back(row_idx, col_idx, grid_id);
+      map_.add(value, GridLink(row_idx, col_idx, grid_id));
     }
   }
 
@@ -175,8 +267,12 @@ void BingoMap::loadGrid(std::ifstream& ifile) {
 
 // draw next value
 // If a grid has bingo, return a pointer to it, else nullptr
-const Grid* BingoMap::draw(int value) {
-  for (auto& link : map_[value]) {
+template <int GridSize, typename Lookup>
+const Grid<GridSize>* BingoMap<GridSize, Lookup>::draw(int value) {
+  const std::vector<GridLink>* links = map_.find(value);
+  if (links == nullptr) return nullptr;
+
+  for (auto& link : *links) {
     if (grids_[link.grid_id].draw(link.row, link.col, value)) {
       // if last player to win, return
       if (--players_left_ == 0) return &grids_[link.grid_id];
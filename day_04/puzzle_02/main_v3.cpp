@@ -0,0 +1,298 @@
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Assumptions:
+//
+// 1. The same number is never drawn twice
+// 2. The same number does not appear twice on a grid
+// 3. Grids are 5x5
+// 4. Possible bingo values are 0-99
+// 5. Input format is valid
+//
+// Bitboard version: every grid is a 25-bit mask of marked cells, cell (row, col) is
+// bit (row * GRID_SIZE + col). Masks and remaining sums are kept as a structure of arrays,
+// so a draw only ORs one bit into each affected grid.
+//
+// Marking a cell can only complete its own row or column, so instead of testing all
+// 10 win masks of every grid after each draw (even with SIMD, that is a sweep over all
+// grids per draw), each link carries the cell index and we test the 2 lines through it.
+//
+// Draws are processed in order, so winners come out already sorted by draw index (and by
+// grid id within a draw, since links are stored in loading order). The ranking keeps them
+// in one flat vector with an offset per draw, i.e. one bucket per draw index.
+//
+namespace {
+
+std::vector<int> readBingoNumbers(std::ifstream& ifile);
+
+constexpr int NUM_VALUES = 100;
+constexpr int GRID_SIZE = 5;
+constexpr int NUM_CELLS = GRID_SIZE * GRID_SIZE;
+
+constexpr std::uint32_t WON_FLAG = std::uint32_t(1) << 31;  // stored in the mark mask
+
+constexpr std::uint32_t rowMask(int cell) {
+  return ((std::uint32_t(1) << GRID_SIZE) - 1) << (GRID_SIZE * (cell / GRID_SIZE));
+}
+
+constexpr std::uint32_t colMask(int cell) {
+  std::uint32_t mask = 0;
+  for (int row = 0; row < GRID_SIZE; ++row) mask |= std::uint32_t(1) << (row * GRID_SIZE);
+  return mask << (cell % GRID_SIZE);
+}
+
+struct LineMasks {
+  std::uint32_t row;
+  std::uint32_t col;
+};
+
+constexpr std::array<LineMasks, NUM_CELLS> makeLineMasks() {
+  std::array<LineMasks, NUM_CELLS> masks = {};
+  for (int cell = 0; cell < NUM_CELLS; ++cell) masks[cell] = {rowMask(cell), colMask(cell)};
+  return masks;
+}
+
+constexpr std::array<LineMasks, NUM_CELLS> LINE_MASKS = makeLineMasks();
+
+class BitBingo {
+ public:
+  struct Winner {
+    int grid_id = -1;
+    int draw_idx = -1;  // -1 if the grid never wins
+    int value = 0;
+    std::uint32_t remaining_sum = 0;
+
+    std::size_t score() const { return std::size_t(value) * remaining_sum; }
+  };
+
+  // all grids in finishing order, grids that never win are in the last bucket with the
+  // sum of their never drawn values
+  struct Ranking {
+    std::vector<Winner> winners;
+    std::vector<std::size_t> draw_offsets;  // bucket of draw i : [offsets[i], offsets[i + 1])
+
+    const Winner* begin(int draw_idx) const { return winners.data() + draw_offsets[draw_idx]; }
+    const Winner* end(int draw_idx) const { return winners.data() + draw_offsets[draw_idx + 1]; }
+  };
+
+  // load one grid from file, returns false if no complete grid could be read
+  bool loadGrid(std::ifstream& ifile);
+
+  // draw the whole sequence and rank all grids
+  Ranking play(const std::vector<int>& sequence);
+
+  // return number of grids
+  std::size_t size() const;
+
+ private:
+  struct CellLink {
+    std::uint32_t grid_id;
+    std::uint32_t cell;
+  };
+
+  std::array<std::vector<CellLink>, NUM_VALUES> map_;
+  std::vector<std::uint32_t> marks_;      // marked cells + WON_FLAG
+  std::vector<std::uint32_t> remaining_;  // sum of unmarked values
+};
+
+// Writes the ranking as csv through a fixed buffer, so large rankings never sit in memory
+// as text
+class RankingWriter {
+ public:
+  explicit RankingWriter(const std::string& filename);
+  ~RankingWriter();
+
+  bool good() const;
+
+  // rank,grid_id,draw_idx,remaining_sum,score, draw_idx "never" for grids that do not win
+  void write(std::size_t rank, const BitBingo::Winner& winner);
+
+ private:
+  void append(std::size_t value, char separator);
+  void append(const char* text, char separator);
+  void flushBuffer();
+
+  std::ofstream ofile_;
+  std::array<char, 1 << 16> buffer_;
+  std::size_t used_ = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <filename> [ranking_file]" << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  std::ifstream ifile(filename);
+
+  if (!ifile.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  // read first line -> sequence of drawn numbers
+  std::vector<int> sequence = readBingoNumbers(ifile);
+
+  // load grids
+  BitBingo bingo;
+  while (bingo.loadGrid(ifile)) {
+  }
+  std::cout << "Loaded " << bingo.size() << " grids" << std::endl;
+
+  auto t_start = std::chrono::steady_clock::now();
+  BitBingo::Ranking ranking = bingo.play(sequence);
+  auto t_end = std::chrono::steady_clock::now();
+
+  if (sequence.empty() || ranking.begin(0) == ranking.end(sequence.size() - 1)) {
+    std::cout << "Nobody won" << std::endl;
+    return 1;
+  }
+  const BitBingo::Winner& first = *ranking.begin(0);
+  const BitBingo::Winner& last = *(ranking.end(sequence.size() - 1) - 1);
+
+  std::cout << "Grid " << first.grid_id << " won first with a remainder of "
+            << first.remaining_sum << std::endl;
+  std::cout << "Total score: " << first.score() << std::endl;
+  std::cout << "Grid " << last.grid_id << " won last with a remainder of " << last.remaining_sum
+            << std::endl;
+  std::cout << "Total score: " << last.score() << std::endl;
+  std::cout << "Total time: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()
+            << std::endl;
+
+  if (argc > 2) {
+    RankingWriter writer(argv[2]);
+    if (!writer.good()) {
+      std::cout << "Could not open " << argv[2] << std::endl;
+      return 1;
+    }
+    std::size_t rank = 0;
+    for (const auto& winner : ranking.winners) writer.write(++rank, winner);
+  }
+
+  return 0;
+}
+
+namespace {
+
+std::vector<int> readBingoNumbers(std::ifstream& ifile) {
+  std::vector<int> values;
+  std::string line;
+  std::getline(ifile, line);
+  std::istringstream iss(line);
+
+  std::string value_str;
+  while (std::getline(iss, value_str, ',')) {
+    values.push_back(std::stoi(value_str));
+  }
+
+  return values;
+}
+
+bool BitBingo::loadGrid(std::ifstream& ifile) {
+  std::array<int, NUM_CELLS> values;
+  for (auto& value : values) {
+    if (!(ifile >> value)) return false;
+  }
+
+  std::uint32_t grid_id = marks_.size();
+  std::uint32_t sum = 0;
+  for (std::uint32_t cell = 0; cell < NUM_CELLS; ++cell) {
+    sum += values[cell];
+    map_[values[cell]].push_back({grid_id, cell});
+  }
+
+  marks_.push_back(0);
+  remaining_.push_back(sum);
+  return true;
+}
+
+BitBingo::Ranking BitBingo::play(const std::vector<int>& sequence) {
+  Ranking ranking;
+  ranking.winners.reserve(marks_.size());
+  ranking.draw_offsets.reserve(sequence.size() + 2);
+  std::size_t players_left = marks_.size();
+
+  for (int draw_idx = 0; draw_idx < int(sequence.size()) && players_left > 0; ++draw_idx) {
+    ranking.draw_offsets.push_back(ranking.winners.size());
+    const int value = sequence[draw_idx];
+    for (const auto& link : map_[value]) {
+      std::uint32_t& marks = marks_[link.grid_id];
+      if (marks & WON_FLAG) continue;
+
+      marks |= std::uint32_t(1) << link.cell;
+      remaining_[link.grid_id] -= value;
+
+      const LineMasks& lines = LINE_MASKS[link.cell];
+      if ((marks & lines.row) == lines.row || (marks & lines.col) == lines.col) {
+        marks |= WON_FLAG;
+        ranking.winners.push_back({int(link.grid_id), draw_idx, value, remaining_[link.grid_id]});
+        --players_left;
+      }
+    }
+  }
+
+  // remaining draws are empty buckets, losers go to the last bucket
+  ranking.draw_offsets.resize(sequence.size() + 1, ranking.winners.size());
+  for (std::size_t grid_id = 0; grid_id < marks_.size(); ++grid_id) {
+    if (!(marks_[grid_id] & WON_FLAG)) {
+      ranking.winners.push_back({int(grid_id), -1, 0, remaining_[grid_id]});
+    }
+  }
+  ranking.draw_offsets.push_back(ranking.winners.size());
+
+  return ranking;
+}
+
+std::size_t BitBingo::size() const { return marks_.size(); }
+
+RankingWriter::RankingWriter(const std::string& filename) : ofile_(filename) {
+  ofile_ << "rank,grid_id,draw_idx,remaining_sum,score\n";
+}
+
+RankingWriter::~RankingWriter() { flushBuffer(); }
+
+bool RankingWriter::good() const { return ofile_.good(); }
+
+void RankingWriter::write(std::size_t rank, const BitBingo::Winner& winner) {
+  // a line is at most 5 * 21 characters
+  if (buffer_.size() - used_ < 128) flushBuffer();
+
+  append(rank, ',');
+  append(winner.grid_id, ',');
+  if (winner.draw_idx < 0) {
+    append("never", ',');
+  } else {
+    append(winner.draw_idx, ',');
+  }
+  append(winner.remaining_sum, ',');
+  append(winner.score(), '\n');
+}
+
+void RankingWriter::append(std::size_t value, char separator) {
+  char* end = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value).ptr;
+  *end++ = separator;
+  used_ = end - buffer_.data();
+}
+
+void RankingWriter::append(const char* text, char separator) {
+  for (; *text != '\0'; ++text) buffer_[used_++] = *text;
+  buffer_[used_++] = separator;
+}
+
+void RankingWriter::flushBuffer() {
+  ofile_.write(buffer_.data(), used_);
+  used_ = 0;
+}
+
+}  // namespace
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Assumptions:
+//
+// 1. The same number is never drawn twice
+// 2. The same number does not appear twice on a grid
+// 3. Grids are 5x5
+// 4. Possible bingo values are 0-99
+// 5. Input format is valid
+//
+// Rank version: no draws are simulated. With rank[value] the index at which value is drawn,
+//
+//   a line is complete at  max(rank[v] for v in line)
+//   a grid wins at         min(complete time of its 5 rows and 5 columns)
+//
+// Every grid is scored on its own in O(cells), so the loop over grids is embarrassingly
+// parallel. Sorting by (win draw, grid id) gives the full ranking, in the same order as a
+// draw by draw simulation would find the winners.
+//
+// For first / last winner only, grids are split into contiguous shards scored on separate
+// threads. Each shard keeps its local first and last winner, and the reduction picks the
+// global ones with the same (win draw, grid id) order, so the result does not depend on
+// the number of shards. Grids that never win are skipped in the shards already, they would
+// otherwise always finish last.
+//
+namespace {
+
+std::vector<int> readBingoNumbers(std::ifstream& ifile);
+
+constexpr int NUM_VALUES = 100;
+constexpr int GRID_SIZE = 5;
+constexpr int NUM_CELLS = GRID_SIZE * GRID_SIZE;
+
+struct Result {
+  int grid_id;
+  int draw_idx;                 // == sequence size if the grid never wins
+  std::uint32_t remaining_sum;  // unmarked cells after the win, or after all draws
+  std::size_t score;
+};
+
+// finishing order : earlier draw first, lower grid id on ties
+bool finishesBefore(const Result& a, const Result& b);
+
+class RankBingo {
+ public:
+  explicit RankBingo(const std::vector<int>& sequence);
+
+  // load one grid from file, returns false if no complete grid could be read
+  bool loadGrid(std::ifstream& ifile);
+
+  // compute win time and score of a single grid
+  Result score(int grid_id) const;
+
+  // all grids, ordered by finishing position
+  std::vector<Result> ranking() const;
+
+  // first and last winner, scoring num_shards ranges of grids in parallel
+  // grid_id is -1 if no grid wins
+  std::array<Result, 2> winners(int num_shards) const;
+
+  // false for grids that are still playing after the whole sequence
+  bool won(const Result& result) const;
+
+  // return number of grids
+  std::size_t size() const;
+
+ private:
+  const std::vector<int>& sequence_;
+  std::array<int, NUM_VALUES> rank_;   // draw index of each value
+  std::vector<std::uint8_t> cells_;    // row major, NUM_CELLS per grid
+};
+
+bool finishesBefore(const Result& a, const Result& b) {
+  return (a.draw_idx != b.draw_idx) ? a.draw_idx < b.draw_idx : a.grid_id < b.grid_id;
+}
+
+void printResult(const char* label, const Result& result);
+
+// rank,grid_id,draw_idx,remaining_sum,score as written by main_v3, draw_idx "never" for
+// grids that do not win
+void printRanking(const RankBingo& bingo);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <filename> [print_ranking] [num_threads]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  std::ifstream ifile(filename);
+  bool print_ranking = argc > 2 && std::atoi(argv[2]) != 0;
+  int num_threads = argc > 3 ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+  if (!ifile.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  // read first line -> sequence of drawn numbers
+  std::vector<int> sequence = readBingoNumbers(ifile);
+
+  // load grids
+  RankBingo bingo(sequence);
+  while (bingo.loadGrid(ifile)) {
+  }
+  std::cout << "Loaded " << bingo.size() << " grids" << std::endl;
+  if (bingo.size() == 0) return 1;
+
+  auto t_start = std::chrono::steady_clock::now();
+  auto [first, last] = bingo.winners(std::max(num_threads, 1));
+  auto t_end = std::chrono::steady_clock::now();
+
+  if (first.grid_id < 0) {
+    std::cout << "Nobody won" << std::endl;
+    return 1;
+  }
+
+  printResult("first", first);
+  printResult("last", last);
+  if (print_ranking) printRanking(bingo);
+  std::cout << "Total time: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()
+            << std::endl;
+
+  return 0;
+}
+
+namespace {
+
+std::vector<int> readBingoNumbers(std::ifstream& ifile) {
+  std::vector<int> values;
+  std::string line;
+  std::getline(ifile, line);
+  std::istringstream iss(line);
+
+  std::string value_str;
+  while (std::getline(iss, value_str, ',')) {
+    values.push_back(std::stoi(value_str));
+  }
+
+  return values;
+}
+
+void printResult(const char* label, const Result& result) {
+  std::cout << "Grid " << result.grid_id << " won " << label << " at draw " << result.draw_idx
+            << " with a remainder of " << result.remaining_sum << std::endl;
+  std::cout << "Total score: " << result.score << std::endl;
+}
+
+void printRanking(const RankBingo& bingo) {
+  std::cout << "rank,grid_id,draw_idx,remaining_sum,score\n";
+  std::size_t rank = 0;
+  for (const auto& result : bingo.ranking()) {
+    std::cout << ++rank << "," << result.grid_id << ",";
+    if (bingo.won(result)) {
+      std::cout << result.draw_idx;
+    } else {
+      std::cout << "never";
+    }
+    std::cout << "," << result.remaining_sum << "," << result.score << "\n";
+  }
+}
+
+RankBingo::RankBingo(const std::vector<int>& sequence) : sequence_{sequence} {
+  rank_.fill(sequence.size());  // never drawn
+  for (int draw_idx = 0; draw_idx < int(sequence.size()); ++draw_idx) {
+    rank_[sequence[draw_idx]] = draw_idx;
+  }
+}
+
+bool RankBingo::loadGrid(std::ifstream& ifile) {
+  std::array<int, NUM_CELLS> values;
+  for (auto& value : values) {
+    if (!(ifile >> value)) return false;
+  }
+
+  cells_.insert(cells_.end(), values.cbegin(), values.cend());
+  return true;
+}
+
+Result RankBingo::score(int grid_id) const {
+  const std::uint8_t* cells = &cells_[std::size_t(grid_id) * NUM_CELLS];
+
+  std::array<int, NUM_CELLS> ranks;
+  for (int cell = 0; cell < NUM_CELLS; ++cell) ranks[cell] = rank_[cells[cell]];
+
+  int win = sequence_.size();
+  for (int i = 0; i < GRID_SIZE; ++i) {
+    int row_done = 0;
+    int col_done = 0;
+    for (int j = 0; j < GRID_SIZE; ++j) {
+      row_done = std::max(row_done, ranks[i * GRID_SIZE + j]);
+      col_done = std::max(col_done, ranks[j * GRID_SIZE + i]);
+    }
+    win = std::min(win, std::min(row_done, col_done));
+  }
+
+  // a grid that never wins has every drawn value marked, only never drawn ones remain
+  const int last_marked = std::min(win, int(sequence_.size()) - 1);
+  std::uint32_t remaining_sum = 0;
+  for (int cell = 0; cell < NUM_CELLS; ++cell) {
+    if (ranks[cell] > last_marked) remaining_sum += cells[cell];
+  }
+
+  std::size_t last_value = win < int(sequence_.size()) ? sequence_[win] : 0;
+  return {grid_id, win, remaining_sum, last_value * remaining_sum};
+}
+
+std::vector<Result> RankBingo::ranking() const {
+  std::vector<Result> results;
+  results.reserve(size());
+  for (int grid_id = 0; grid_id < int(size()); ++grid_id) {
+    results.push_back(score(grid_id));
+  }
+
+  std::sort(results.begin(), results.end(), finishesBefore);
+  return results;
+}
+
+std::array<Result, 2> RankBingo::winners(int num_shards) const {
+  const int num_grids = size();
+  num_shards = std::min(num_shards, num_grids);
+  std::vector<std::array<Result, 2>> shard_winners(num_shards);
+
+  auto scoreShard = [&](int shard) {
+    const int begin = std::size_t(num_grids) * shard / num_shards;
+    const int end = std::size_t(num_grids) * (shard + 1) / num_shards;
+
+    Result first = {-1, 0, 0, 0};
+    Result last = first;
+    for (int grid_id = begin; grid_id < end; ++grid_id) {
+      Result result = score(grid_id);
+      if (!won(result)) continue;
+      if (first.grid_id < 0 || finishesBefore(result, first)) first = result;
+      if (last.grid_id < 0 || finishesBefore(last, result)) last = result;
+    }
+    shard_winners[shard] = {first, last};
+  };
+
+  std::vector<std::thread> threads;
+  for (int shard = 1; shard < num_shards; ++shard) threads.emplace_back(scoreShard, shard);
+  scoreShard(0);
+  for (auto& thread : threads) thread.join();
+
+  // reduction, shards are visited in grid order but ties are resolved by grid id anyway
+  std::array<Result, 2> winners = shard_winners.front();
+  for (const auto& [first, last] : shard_winners) {
+    if (first.grid_id < 0) continue;  // no winner in this shard
+    if (winners[0].grid_id < 0 || finishesBefore(first, winners[0])) winners[0] = first;
+    if (winners[1].grid_id < 0 || finishesBefore(winners[1], last)) winners[1] = last;
+  }
+  return winners;
+}
+
+bool RankBingo::won(const Result& result) const {
+  return result.draw_idx < int(sequence_.size());
+}
+
+std::size_t RankBingo::size() const { return cells_.size() / NUM_CELLS; }
+
+}  // namespace
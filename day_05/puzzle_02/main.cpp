@@ -1,13 +1,80 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Engines (second argument, default auto):
+//
+// dense   : brute force, one int counter per cell of a 1000x1000 field
+// compact : field sized to the bounding box of the segments, storing a saturating 2-bit
+//           counter per cell as two bitsets (seen once, seen at least twice). 16x less
+//           memory than int counters, so mid-sized maps stay in cache
+// tiled   : compact field split into bands of rows. Segments are binned into the bands they
+//           cross (clipped to the band), and bands are rasterized and counted independently
+//           by a pool of threads (third argument, default: all cores). Every cell belongs to
+//           exactly one band, so no atomics are needed and the counts just add up
+// sweep   : sweep line over the rows, memory only depends on the number of segments
+//           At each row, the active segments give one interval each (a horizontal line gives
+//           its x range, vertical and diagonal lines a single cell), and the cells covered by
+//           at least two intervals are counted from the sorted interval ends. Rows with fewer
+//           than two active segments are skipped entirely, rows and ends are 64 bit.
+// analytic: no rasterization, for few but long segments. Segments are grouped by
+//           direction family (horizontal, vertical, both diagonals) and supporting line.
+//           Within a line, sorted intervals give the union and the cells covered twice.
+//           Across families, lines cross in at most one cell: the union pieces are swept by
+//           x and every crossing of two overlapping pieces is collected in a hash set.
+//           Crossings are then counted once, minus what the lines already counted
+// auto    : analytic if (number of segments)^2 < total segment length, else compact (tiled
+//           if several cores) if the bounding box is small enough, else sweep
+//
+// With a fourth argument, the compact and tiled engines also export the field as a PGM
+// heatmap (black : no vent, gray : one vent, white : danger) while counting. The image is
+// written straight into a memory mapped file, and fields larger than maxHeatmapSize per side
+// are downsampled, each pixel showing the highest level of its block.
+//
 namespace {
 
+enum class Engine { AUTO, DENSE, COMPACT, TILED, SWEEP, ANALYTIC };
+
+struct Segment {
+  int xA;
+  int yA;
+  int xB;
+  int yB;
+};
+
+std::vector<Segment> readSegments(std::ifstream& ifile) {
+  static constexpr int lengthArrow = 4;
+
+  std::vector<Segment> segments;
+  Segment s;
+  char c;
+  while (ifile >> s.xA >> c >> s.yA) {
+    ifile.seekg(lengthArrow, std::ios::cur);
+    ifile >> s.xB >> c >> s.yB;
+    segments.push_back(s);
+    //    std::cout << s.xA << "," << s.yA << " --> " << s.xB << "," << s.yB << std::endl;
+  }
+  return segments;
+}
+
 void printField(const std::vector<int>& field, int width) {
   auto it = field.cbegin();
   std::size_t counter = 0;
@@ -22,39 +89,91 @@ void printField(const std::vector<int>& field, int width) {
   }
 }
 
+static constexpr int criticalDanger = 2;
+static constexpr int fieldSize = 1000;
+static constexpr std::int64_t maxFieldCells = std::int64_t(1) << 30;  // 256 MB as bitsets
+
+struct BoundingBox {
+  int xMin;
+  int yMin;
+  int xMax;
+  int yMax;
+
+  std::int64_t width() const { return std::int64_t(xMax) - xMin + 1; }
+  std::int64_t height() const { return std::int64_t(yMax) - yMin + 1; }
+
+  // at most maxFieldCells cells, without the width * height that overflows for boxes
+  // spanning most of the int range
+  bool fitsField() const { return height() <= 0 || width() <= maxFieldCells / height(); }
+};
+
+BoundingBox boundingBox(const std::vector<Segment>& segments) {
+  BoundingBox box{0, 0, -1, -1};
+  if (segments.empty()) return box;
+
+  box = {segments[0].xA, segments[0].yA, segments[0].xA, segments[0].yA};
+  for (const auto& s : segments) {
+    box.xMin = std::min({box.xMin, s.xA, s.xB});
+    box.yMin = std::min({box.yMin, s.yA, s.yB});
+    box.xMax = std::max({box.xMax, s.xA, s.xB});
+    box.yMax = std::max({box.yMax, s.yA, s.yB});
+  }
+  return box;
+}
+
+// Saturating 2-bit counter per cell, stored as two bitsets
+class DangerField {
+ public:
+  // box must fit a field, for a box that does not the field stays empty
+  explicit DangerField(const BoundingBox& box);
+
+  void rasterize(const Segment& s);
+
+  // number of cells seen at least twice
+  std::int64_t dangerCount() const;
+
+  // call f(x, y, level) for every cell with at least one vent, level 2 if dangerous
+  // empty words of 64 cells are skipped at once
+  template <typename F>
+  void forEachVent(F f) const {
+    for (std::size_t word = 0; word < once_.size(); ++word) {
+      for (std::uint64_t bits = once_[word]; bits != 0; bits &= bits - 1) {
+        const int bit = __builtin_ctzll(bits);
+        const std::int64_t idx = word * 64 + bit;
+        f(box_.xMin + idx % box_.width(), box_.yMin + idx / box_.width(),
+          1 + ((twice_[word] >> bit) & 1));
+      }
+    }
+  }
+
+
+ private:
+  void mark(std::int64_t idx) {
+    const std::uint64_t bit = std::uint64_t(1) << (idx & 63);
+    twice_[idx >> 6] |= once_[idx >> 6] & bit;
+    once_[idx >> 6] |= bit;
+  }
+
+  static std::size_t numWords(const BoundingBox& box);
+
+  BoundingBox box_;
+  std::vector<std::uint64_t> once_;
+  std::vector<std::uint64_t> twice_;
+};
+
 // brute force, use array
 // assume we know the max values are < 1000
-int findMaxOverlap(std::ifstream& ifile) {
-  static constexpr int lengthArrow = 4;
-  static constexpr int criticalDanger = 2;
-  static constexpr int fieldSize = 1000;
-
+std::int64_t findMaxOverlap(const std::vector<Segment>& segments) {
   // row first indexing
   int N = fieldSize;
   std::vector<int> field(N * N, 0);
   auto getIdx = [N](int x, int y) { return x + y * N; };
 
-  int xA = 0;
-  int yA = 0;
-  int xB = 0;
-  int yB = 0;
-
-  int dangerCount = 0;
-  auto readLine = [&]() {
-    char c;
-    ifile >> xA >> c >> yA;
-    ifile.seekg(lengthArrow, std::ios::cur);
-    ifile >> xB >> c >> yB;
-
-    //    std::cout << xA << "," << yA << " --> " << xB << "," << yB << std::endl;
-  };
-
   int stepSize = 0;
   int numSteps = 0;
 
-  while (ifile.good()) {
-    readLine();
-
+  std::int64_t dangerCount = 0;
+  for (auto [xA, yA, xB, yB] : segments) {
     // yA == yB : horizontal direction, else vertical direction
     if (yA == yB) {
       if (xA > xB) std::swap(xA, xB);
@@ -88,11 +207,374 @@ int findMaxOverlap(std::ifstream& ifile) {
   return dangerCount;
 }
 
+DangerField::DangerField(const BoundingBox& box)
+    : box_{box},
+      once_(numWords(box), 0),
+      twice_(numWords(box), 0) {}
+
+std::size_t DangerField::numWords(const BoundingBox& box) {
+  return box.fitsField() ? (box.width() * box.height() + 63) / 64 : 0;
+}
+
+void DangerField::rasterize(const Segment& s) {
+  const std::int64_t dx = (s.xB > s.xA) - (s.xB < s.xA);
+  const std::int64_t dy = (s.yB > s.yA) - (s.yB < s.yA);
+  const std::int64_t stepSize = dx + dy * box_.width();
+  const int numSteps = 1 + std::max(std::abs(s.xB - s.xA), std::abs(s.yB - s.yA));
+
+  std::int64_t idx = (s.xA - box_.xMin) + (s.yA - box_.yMin) * box_.width();  // starting point
+  for (int i = 0; i < numSteps; ++i, idx += stepSize) mark(idx);
+}
+
+std::int64_t DangerField::dangerCount() const {
+  std::int64_t count = 0;
+  for (auto word : twice_) count += __builtin_popcountll(word);
+  return count;
+}
+
+// Binary PGM of the whole bounding box in a memory mapped file
+class Heatmap {
+ public:
+  static constexpr std::int64_t maxHeatmapSize = 4096;
+
+  Heatmap(const std::string& filename, const BoundingBox& box);
+  ~Heatmap();
+
+  bool good() const { return data_ != nullptr; }
+
+  // field rows per pixel row
+  std::int64_t scale() const { return scale_; }
+
+  // draw part of the field, its first row must be a multiple of scale() away from the top
+  void draw(const DangerField& field);
+
+ private:
+  BoundingBox box_;
+  std::int64_t scale_;
+  std::int64_t width_;   // in pixels
+  std::int64_t height_;  // in pixels
+  std::size_t header_size_ = 0;
+  std::size_t size_ = 0;
+  int fd_ = -1;
+  unsigned char* data_ = nullptr;
+};
+
+Heatmap::Heatmap(const std::string& filename, const BoundingBox& box)
+    : box_{box},
+      // an empty box (no segments) gives a 0x0 image
+      scale_{std::max<std::int64_t>(
+          (std::max(box.width(), box.height()) + maxHeatmapSize - 1) / maxHeatmapSize, 1)},
+      width_{(box.width() + scale_ - 1) / scale_},
+      height_{(box.height() + scale_ - 1) / scale_} {
+  const std::string header =
+      "P5\n" + std::to_string(width_) + " " + std::to_string(height_) + "\n255\n";
+  header_size_ = header.size();
+  size_ = header_size_ + width_ * height_;
+
+  fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0 || ::ftruncate(fd_, size_) != 0) return;
+
+  void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) return;
+
+  // file is zero filled by ftruncate, i.e. black
+  data_ = static_cast<unsigned char*>(data);
+  std::copy(header.cbegin(), header.cend(), data_);
+}
+
+Heatmap::~Heatmap() {
+  if (data_ != nullptr) ::munmap(data_, size_);
+  if (fd_ >= 0) ::close(fd_);
+}
+
+void Heatmap::draw(const DangerField& field) {
+  static constexpr unsigned char gray[] = {0, 128, 255};
+
+  unsigned char* pixels = data_ + header_size_;
+  field.forEachVent([&](std::int64_t x, std::int64_t y, int level) {
+    unsigned char& pixel = pixels[((y - box_.yMin) / scale_) * width_ + (x - box_.xMin) / scale_];
+    pixel = std::max(pixel, gray[level]);
+  });
+}
+
+std::int64_t compactOverlap(const std::vector<Segment>& segments, const BoundingBox& box,
+                            Heatmap* heatmap) {
+  DangerField field(box);
+  for (const auto& s : segments) field.rasterize(s);
+  if (heatmap != nullptr) heatmap->draw(field);
+  return field.dangerCount();
+}
+
+// part of s within rows [y0, y1], s must cross these rows
+Segment clipRows(const Segment& s, int y0, int y1) {
+  if (s.yA == s.yB) return s;
+
+  const int dx = (s.xB > s.xA) - (s.xB < s.xA);
+  const int dy = (s.yB > s.yA) ? 1 : -1;
+  auto pointAtRow = [&](int y) { return std::pair(s.xA + dx * dy * (y - s.yA), y); };
+
+  auto [xA, yA] = pointAtRow(std::clamp(s.yA, y0, y1));
+  auto [xB, yB] = pointAtRow(std::clamp(s.yB, y0, y1));
+  return {xA, yA, xB, yB};
+}
+
+std::int64_t tiledOverlap(const std::vector<Segment>& segments, const BoundingBox& box,
+                          int numThreads, Heatmap* heatmap) {
+  // a few bands per thread to balance uneven density
+  // with a heatmap, bands cover whole pixel rows so that threads never share a pixel
+  const std::int64_t rowsPerPixel = (heatmap != nullptr) ? heatmap->scale() : 1;
+  std::int64_t tileHeight = (box.height() + 8 * numThreads - 1) / (8 * numThreads);
+  tileHeight = (tileHeight + rowsPerPixel - 1) / rowsPerPixel * rowsPerPixel;
+  const int numTiles = (box.height() + tileHeight - 1) / tileHeight;
+  auto tileOf = [&](int y) { return int((y - std::int64_t(box.yMin)) / tileHeight); };
+
+  std::vector<std::vector<Segment>> tiles(numTiles);
+  for (const auto& s : segments) {
+    const int first = tileOf(std::min(s.yA, s.yB));
+    const int last = tileOf(std::max(s.yA, s.yB));
+    for (int tile = first; tile <= last; ++tile) {
+      const int y0 = box.yMin + tile * tileHeight;
+      tiles[tile].push_back(clipRows(s, y0, y0 + tileHeight - 1));
+    }
+  }
+
+  std::atomic<int> nextTile = 0;
+  std::vector<std::int64_t> counts(numThreads, 0);
+  auto worker = [&](int thread) {
+    for (int tile = nextTile++; tile < numTiles; tile = nextTile++) {
+      const int y0 = box.yMin + tile * tileHeight;
+      const int y1 = std::min<std::int64_t>(y0 + tileHeight - 1, box.yMax);
+      DangerField field({box.xMin, y0, box.xMax, y1});
+      for (const auto& s : tiles[tile]) field.rasterize(s);
+      if (heatmap != nullptr) heatmap->draw(field);
+      counts[thread] += field.dangerCount();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < numThreads; ++thread) threads.emplace_back(worker, thread);
+  worker(0);
+  for (auto& thread : threads) thread.join();
+
+  std::int64_t dangerCount = 0;
+  for (auto count : counts) dangerCount += count;
+  return dangerCount;
+}
+
+std::int64_t sweepOverlap(std::vector<Segment> segments) {
+  // sweep from top to bottom : yA <= yB, sorted by first row
+  for (auto& s : segments) {
+    if (s.yA > s.yB) {
+      std::swap(s.xA, s.xB);
+      std::swap(s.yA, s.yB);
+    }
+  }
+  std::sort(segments.begin(), segments.end(),
+            [](const Segment& a, const Segment& b) { return a.yA < b.yA; });
+
+  // 64 bit rows and ends, one past INT_MAX and the width of a full int range still fit
+  std::vector<Segment> active;
+  std::vector<std::pair<std::int64_t, int>> ends;  // (x, +1 : first cell / -1 : one past last)
+
+  std::int64_t dangerCount = 0;
+  std::size_t next = 0;
+  std::int64_t y = 0;
+  while (next < segments.size() || !active.empty()) {
+    if (active.size() < std::size_t(criticalDanger)) {
+      // too few segments to overlap, jump to the next row where one starts or ends
+      y = next < segments.size() ? segments[next].yA : std::numeric_limits<std::int64_t>::max();
+      for (const auto& s : active) y = std::min(y, std::int64_t(s.yB) + 1);
+    }
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [y](const Segment& s) { return s.yB < y; }),
+                 active.end());
+    while (next < segments.size() && segments[next].yA == y) active.push_back(segments[next++]);
+
+    ends.clear();
+    for (const auto& s : active) {
+      if (s.yA == s.yB) {  // horizontal
+        ends.emplace_back(std::min(s.xA, s.xB), 1);
+        ends.emplace_back(std::int64_t(std::max(s.xA, s.xB)) + 1, -1);
+      } else {  // vertical or diagonal : one cell in this row
+        std::int64_t x = s.xA + (s.xB > s.xA ? 1 : (s.xB < s.xA ? -1 : 0)) * (y - s.yA);
+        ends.emplace_back(x, 1);
+        ends.emplace_back(x + 1, -1);
+      }
+    }
+    std::sort(ends.begin(), ends.end());
+
+    // count cells between ends where at least two intervals overlap
+    int depth = 0;
+    for (std::size_t i = 0; i < ends.size();) {
+      const std::int64_t x = ends[i].first;
+      for (; i < ends.size() && ends[i].first == x; ++i) depth += ends[i].second;
+      if (depth >= criticalDanger) dangerCount += ends[i].first - x;  // depth > 0 -> i valid
+    }
+
+    ++y;
+  }
+
+  return dangerCount;
+}
+
+enum Family { HORIZONTAL, VERTICAL, DIAGONAL_UP, DIAGONAL_DOWN, NUM_FAMILIES };
+
+// Each family parametrizes its lines by key and the cells of a line by param
+//   horizontal : key y, param x      vertical   : key x, param y
+//   diagonal up: key x - y, param x  diagonal down : key x + y, param x
+struct Piece {
+  Family family;
+  std::int64_t key;
+  std::int64_t lo;  // param range, inclusive
+  std::int64_t hi;
+
+  std::int64_t xMin() const { return family == VERTICAL ? key : lo; }
+  std::int64_t xMax() const { return family == VERTICAL ? key : hi; }
+};
+
+Piece toPiece(const Segment& s) {
+  const std::int64_t xA = s.xA, yA = s.yA, xB = s.xB, yB = s.yB;
+  if (yA == yB) return {HORIZONTAL, yA, std::min(xA, xB), std::max(xA, xB)};
+  if (xA == xB) return {VERTICAL, xA, std::min(yA, yB), std::max(yA, yB)};
+  if ((xB - xA) == (yB - yA)) return {DIAGONAL_UP, xA - yA, std::min(xA, xB), std::max(xA, xB)};
+  return {DIAGONAL_DOWN, xA + yA, std::min(xA, xB), std::max(xA, xB)};
+}
+
+std::int64_t keyOf(Family family, std::int64_t x, std::int64_t y) {
+  switch (family) {
+    case HORIZONTAL:
+      return y;
+    case VERTICAL:
+      return x;
+    case DIAGONAL_UP:
+      return x - y;
+    default:
+      return x + y;
+  }
+}
+
+std::int64_t paramOf(Family family, std::int64_t x, std::int64_t y) {
+  return family == VERTICAL ? y : x;
+}
+
+bool contains(const Piece& p, std::int64_t x, std::int64_t y) {
+  const std::int64_t param = paramOf(p.family, x, y);
+  return keyOf(p.family, x, y) == p.key && p.lo <= param && param <= p.hi;
+}
+
+// cell where the lines of two pieces from different families cross, if any
+bool crossing(const Piece& a, const Piece& b, std::int64_t& x, std::int64_t& y) {
+  const Piece& p = a.family < b.family ? a : b;
+  const Piece& q = a.family < b.family ? b : a;
+  switch (p.family) {
+    case HORIZONTAL:
+      y = p.key;
+      x = (q.family == VERTICAL) ? q.key : (q.family == DIAGONAL_UP ? q.key + y : q.key - y);
+      break;
+    case VERTICAL:
+      x = p.key;
+      y = (q.family == DIAGONAL_UP) ? x - q.key : q.key - x;
+      break;
+    default:  // both diagonals : x - y = p.key, x + y = q.key
+      if ((p.key + q.key) % 2 != 0) return false;
+      x = (p.key + q.key) / 2;
+      y = (q.key - p.key) / 2;
+      break;
+  }
+  return contains(p, x, y) && contains(q, x, y);
+}
+
+std::int64_t analyticOverlap(const std::vector<Segment>& segments) {
+  using Interval = std::pair<std::int64_t, std::int64_t>;
+  std::array<std::unordered_map<std::int64_t, std::vector<Interval>>, NUM_FAMILIES> lines;
+  for (const auto& s : segments) {
+    Piece piece = toPiece(s);
+    lines[piece.family][piece.key].emplace_back(piece.lo, piece.hi);
+  }
+
+  // per line : union of intervals (pieces) and intervals covered at least twice (multi)
+  std::int64_t dangerCount = 0;
+  std::vector<Piece> pieces;
+  std::array<std::unordered_map<std::int64_t, std::vector<Interval>>, NUM_FAMILIES> multi;
+  std::vector<std::pair<std::int64_t, int>> ends;
+  for (int family = 0; family < NUM_FAMILIES; ++family) {
+    for (const auto& [key, intervals] : lines[family]) {
+      ends.clear();
+      for (const auto& [lo, hi] : intervals) {
+        ends.emplace_back(lo, 1);
+        ends.emplace_back(hi + 1, -1);
+      }
+      std::sort(ends.begin(), ends.end());
+
+      int depth = 0;
+      std::int64_t pieceStart = 0;
+      for (std::size_t i = 0; i < ends.size();) {
+        const std::int64_t param = ends[i].first;
+        const int before = depth;
+        for (; i < ends.size() && ends[i].first == param; ++i) depth += ends[i].second;
+
+        if (before == 0 && depth > 0) pieceStart = param;
+        if (before > 0 && depth == 0) {
+          pieces.push_back({Family(family), key, pieceStart, param - 1});
+        }
+        if (depth >= criticalDanger) {
+          multi[family][key].emplace_back(param, ends[i].first - 1);  // depth > 0 -> i valid
+          dangerCount += ends[i].first - param;
+        }
+      }
+    }
+  }
+
+  // number of families whose lines cover (x, y) at least twice
+  auto multiCount = [&](std::int64_t x, std::int64_t y) {
+    int count = 0;
+    for (int family = 0; family < NUM_FAMILIES; ++family) {
+      auto it = multi[family].find(keyOf(Family(family), x, y));
+      if (it == multi[family].end()) continue;
+
+      // intervals are sorted and disjoint
+      const std::int64_t param = paramOf(Family(family), x, y);
+      auto next = std::upper_bound(it->second.cbegin(), it->second.cend(),
+                                   Interval(param, std::numeric_limits<std::int64_t>::max()));
+      if (next != it->second.cbegin() && std::prev(next)->second >= param) ++count;
+    }
+    return count;
+  };
+
+  // sweep pieces by x, only pieces with overlapping x ranges can cross
+  std::sort(pieces.begin(), pieces.end(),
+            [](const Piece& a, const Piece& b) { return a.xMin() < b.xMin(); });
+  std::vector<const Piece*> active;
+  std::unordered_set<std::uint64_t> crossings;
+  for (const auto& piece : pieces) {
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [&](const Piece* p) { return p->xMax() < piece.xMin(); }),
+                 active.end());
+
+    for (const Piece* other : active) {
+      std::int64_t x, y;
+      if (other->family == piece.family || !crossing(piece, *other, x, y)) continue;
+      crossings.insert((std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y));
+    }
+    active.push_back(&piece);
+  }
+
+  // crossings are dangerous, but may already be counted once per family covering them twice
+  for (std::uint64_t cell : crossings) {
+    const int count = multiCount(std::int32_t(cell >> 32), std::int32_t(cell & 0xffffffff));
+    dangerCount += (count == 0) ? 1 : 1 - count;
+  }
+
+  return dangerCount;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   if (argc < 2) {
-    std::cout << "Require filename as input argument" << std::endl;
+    std::cout << "Required input arguments: <filename> [auto|dense|compact|tiled|sweep|analytic]"
+                 " [num_threads] [heatmap.pgm]"
+              << std::endl;
     return 1;
   }
 
@@ -104,8 +586,87 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  Engine engine = Engine::AUTO;
+  if (argc > 2) {
+    std::string name = argv[2];
+    if (name == "dense") {
+      engine = Engine::DENSE;
+    } else if (name == "compact") {
+      engine = Engine::COMPACT;
+    } else if (name == "tiled") {
+      engine = Engine::TILED;
+    } else if (name == "sweep") {
+      engine = Engine::SWEEP;
+    } else if (name == "analytic") {
+      engine = Engine::ANALYTIC;
+    } else if (name != "auto") {
+      std::cout << "Unknown engine " << name << std::endl;
+      return 1;
+    }
+  }
+  int numThreads = argc > 3 ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+  numThreads = std::max(numThreads, 1);
+
   auto t_start = std::chrono::steady_clock::now();
-  int maxCount = findMaxOverlap(ifile);
+  std::vector<Segment> segments = readSegments(ifile);
+
+  BoundingBox box = boundingBox(segments);
+  if (engine == Engine::AUTO) {
+    // rasterizing costs the total length, the analytic engine up to one check per pair
+    double totalLength = 0;
+    for (const auto& s : segments) {
+      totalLength += 1 + std::max(std::abs(double(s.xB) - s.xA), std::abs(double(s.yB) - s.yA));
+    }
+
+    if (double(segments.size()) * segments.size() < totalLength && argc <= 4) {
+      engine = Engine::ANALYTIC;
+    } else if (!box.fitsField() && argc <= 4) {
+      engine = Engine::SWEEP;
+    } else {
+      engine = (numThreads > 1) ? Engine::TILED : Engine::COMPACT;
+    }
+  }
+
+  if ((engine == Engine::COMPACT || engine == Engine::TILED) && !box.fitsField()) {
+    std::cout << "Bounding box too large for a field, use sweep or analytic" << std::endl;
+    return 1;
+  }
+
+  std::unique_ptr<Heatmap> heatmap;
+  if (argc > 4) {
+    if (engine != Engine::COMPACT && engine != Engine::TILED) {
+      std::cout << "Heatmap requires the compact or tiled engine" << std::endl;
+      return 1;
+    }
+    heatmap = std::make_unique<Heatmap>(argv[4], box);
+    if (!heatmap->good()) {
+      std::cout << "Could not write heatmap to " << argv[4] << std::endl;
+      return 1;
+    }
+  }
+
+  std::int64_t maxCount = 0;
+  switch (engine) {
+    case Engine::DENSE:
+      if (box.xMin < 0 || box.yMin < 0 || box.xMax >= fieldSize || box.yMax >= fieldSize) {
+        std::cout << "Coordinates do not fit in the dense field" << std::endl;
+        return 1;
+      }
+      maxCount = findMaxOverlap(segments);
+      break;
+    case Engine::COMPACT:
+      maxCount = compactOverlap(segments, box, heatmap.get());
+      break;
+    case Engine::TILED:
+      maxCount = segments.empty() ? 0 : tiledOverlap(segments, box, numThreads, heatmap.get());
+      break;
+    case Engine::ANALYTIC:
+      maxCount = analyticOverlap(segments);
+      break;
+    default:
+      maxCount = sweepOverlap(std::move(segments));
+      break;
+  }
   auto t_end = std::chrono::steady_clock::now();
   std::cout << "areas with high danger: " << maxCount << std::endl;
   std::cout << "Execution took "
@@ -1,76 +1,359 @@
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "wide_uint.h"
+
+// Engines (third argument, default linear):
+//
+// linear : advance the spawn / hatching rings one day at a time, O(days)
+// matrix : one day is a linear map on the 9 timer counters (timer t -> t - 1, timer 0 -> 6
+//          and a newborn at 8). The population after d days is 1^T * M^d * v, computed by
+//          applying the cached powers M^(2^k) for the set bits of d, O(log days)
+//
+// <num_days> is a single horizon, a list "d1,d2,..." or a range "first:last[:step]". Several
+// horizons are answered together (one linear sweep up to the last horizon, or a single set
+// of cached matrix powers) and printed as csv lines "days,population".
+//
+// The lifecycle is given by [cycle] (days between two spawns, default 7) and [hatching]
+// (extra days before a newborn enters the cycle, default 2). Lifecycles listed in
+// CompiledLifecycles get ring and matrix sizes as template parameters, and the linear engine
+// unrolls a whole rotation period (lcm(cycle, hatching) days) with constant ring indices.
+// Any other lifecycle runs the linear engine on rings sized at runtime.
+//
+// Counts are stored in the smallest type that holds the upper bound on the population:
+// 64 bit, 128 bit, or WideUInt with up to 64 limbs (4096 bit, enough for ~28000 days)
+//
 namespace {
 
-static constexpr int CYCLE = 7;
-static constexpr int HATCHING = 2;
+static constexpr int DYNAMIC = 0;  // ring size only known at runtime
+static constexpr std::int64_t MAX_HORIZONS = 1 << 20;  // per run, ranges are expanded
+
+struct Lifecycle {
+  int cycle = 7;
+  int hatching = 2;
+
+  int states() const { return cycle + hatching; }  // timer values 0 - (states - 1)
+};
 
-using PopType = std::size_t;  // overflow check triggered for 256 days
+// unrolled engines, add a (cycle, hatching) pair here to compile it in
+template <int Cycle, int Hatching>
+struct CompiledLifecycle {};
 
-std::array<int, CYCLE> readPopulation(std::ifstream& ifile) {
-  std::array<int, CYCLE> fish = {};
+using CompiledLifecycles =
+    std::tuple<CompiledLifecycle<7, 2>, CompiledLifecycle<6, 2>, CompiledLifecycle<8, 3>>;
+
+// upper bound on number of fish : each fish doubles every cycle
+// returns number of bits required to store it
+std::int64_t upperBoundBits(const std::vector<int>& init_pop, int cycle, std::int64_t days) {
+  std::size_t num_fish = std::accumulate(init_pop.cbegin(), init_pop.cend(), int(0));
+  std::int64_t num_bits = 1 + days / cycle;
+  for (; num_fish > 0; num_fish >>= 1) ++num_bits;
+  return num_bits;
+}
+
+// number of fish per timer value, sized to the largest timer found
+std::vector<int> readPopulation(std::ifstream& ifile) {
+  std::vector<int> fish;
 
   // format is val,val,val,...,val
-  int cycle_pos = 0;
-  while (ifile >> cycle_pos) {
-    ++fish[cycle_pos];
+  int timer = 0;
+  while (ifile >> timer) {
+    if (timer >= int(fish.size())) fish.resize(timer + 1, 0);
+    ++fish[timer];
     ifile.get();  // skip comma
   }
 
   return fish;
 }
 
-PopType totalPopulation(const std::array<int, CYCLE>& init_pop, int days) {
-  PopType final_population = 0;
+// Spawn and hatching rings of the linear engine, sizes are template parameters or DYNAMIC
+template <typename PopType, int Cycle, int Hatching>
+class Rings {
+ public:
+  Rings(const Lifecycle& lifecycle, const std::vector<int>& init_pop);
 
-  // upper bound on number of fish : each fish doubles every 7 days
-  std::size_t num_fish = std::accumulate(init_pop.cbegin(), init_pop.cend(), int(0));
-  std::size_t upper_bound = num_fish * ((std::size_t(2) << (days / CYCLE)) - 1);
-  if (upper_bound > std::numeric_limits<PopType>::max()) {
-    std::cout << "Number too big, will overflow!" << std::endl;
-    std::cout << "Upper bound was " << upper_bound << " > " << std::numeric_limits<PopType>::max()
-              << std::endl;
-    return 0;
+  void advance(std::int64_t days);
+
+  // add up all fish that are left
+  PopType total() const;
+
+ private:
+  static constexpr bool COMPILED = Cycle != DYNAMIC && Hatching != DYNAMIC;
+  static constexpr int PERIOD = COMPILED ? std::lcm(Cycle, Hatching) : 0;  // indices repeat
+  static constexpr int MAX_UNROLLED_PERIOD = 64;
+
+  template <typename T, int Size>
+  using Storage = std::conditional_t<Size == DYNAMIC, std::vector<T>, std::array<T, Size>>;
+
+  void step(int spawn, int hatch) {
+    PopType hatching = next_hatching_[hatch];     // eggs that enter the cycle today
+    next_hatching_[hatch] = next_spawns_[spawn];  // eggs that are created today
+    next_spawns_[spawn] += hatching;
   }
 
-  std::array<PopType, CYCLE> next_spawns;
-  std::copy(init_pop.cbegin(), init_pop.cend(), next_spawns.begin());
-  std::array<PopType, HATCHING> next_hatching = {};  // wait 2 days before entering the cycle
+  void stepDay() {
+    step(current_spawn_, current_hatching_);
+    if (++current_spawn_ == int(next_spawns_.size())) current_spawn_ = 0;
+    if (++current_hatching_ == int(next_hatching_.size())) current_hatching_ = 0;
+  }
 
-  auto current_spawn = next_spawns.begin();
-  auto current_hatching = next_hatching.begin();
+  // one rotation period starting at index 0 of both rings, all indices are constants
+  template <std::size_t... Days>
+  void advancePeriod(std::index_sequence<Days...>) {
+    (step(Days % Cycle, Days % Hatching), ...);
+  }
 
-  for (int i = 0; i < days; ++i) {
-    PopType hatching = *current_hatching;  // eggs that enter the cycle today
-    *current_hatching = *current_spawn;    // eggs that are created today
-    *current_spawn += hatching;
+  Storage<PopType, Cycle> next_spawns_ = {};
+  Storage<PopType, Hatching> next_hatching_ = {};  // wait before entering the cycle
+  int current_spawn_ = 0;
+  int current_hatching_ = 0;
+};
 
-    // increase counter
-    if (++current_spawn == next_spawns.end()) current_spawn = next_spawns.begin();
-    if (++current_hatching == next_hatching.end()) current_hatching = next_hatching.begin();
+// population at each of the sorted horizons, in a single sweep
+template <typename PopType, int Cycle, int Hatching>
+std::vector<PopType> totalPopulations(const Lifecycle& lifecycle, const std::vector<int>& init_pop,
+                                      const std::vector<std::int64_t>& horizons) {
+  std::vector<PopType> populations;
+  populations.reserve(horizons.size());
+
+  Rings<PopType, Cycle, Hatching> rings(lifecycle, init_pop);
+  std::int64_t day = 0;
+  for (auto horizon : horizons) {
+    rings.advance(horizon - day);
+    day = horizon;
+    populations.push_back(rings.total());
   }
 
-  // at end, add up all fish that are left
-  final_population += std::accumulate(next_spawns.cbegin(), next_spawns.cend(), PopType(0));
-  final_population += std::accumulate(next_hatching.cbegin(), next_hatching.cend(), PopType(0));
+  return populations;
+}
+
+// Powers of two of the one day transition matrix, computed on first use
+template <typename PopType, int Cycle, int Hatching>
+class TransitionPowers {
+ public:
+  static constexpr int STATES = Cycle + Hatching;
+  using Matrix = std::array<std::array<PopType, STATES>, STATES>;
+
+  TransitionPowers();
+
+  PopType totalPopulation(const std::vector<int>& init_pop, std::int64_t days);
 
+  // all horizons share the cached powers
+  std::vector<PopType> totalPopulations(const std::vector<int>& init_pop,
+                                        const std::vector<std::int64_t>& horizons);
+
+ private:
+  // M^(2^k)
+  const Matrix& power(int k);
+
+  std::vector<Matrix> powers_;
+};
+
+// solve with the given engine, print result and timing
+template <typename PopType, int Cycle, int Hatching>
+void run(const Lifecycle& lifecycle, const std::vector<int>& init_pop,
+         const std::vector<std::int64_t>& horizons, const std::string& engine) {
+  auto t_start = std::chrono::steady_clock::now();
+  std::vector<PopType> populations;
+  if constexpr (Cycle != DYNAMIC && Hatching != DYNAMIC) {
+    if (engine == "matrix") {
+      TransitionPowers<PopType, Cycle, Hatching> powers;
+      populations = powers.totalPopulations(init_pop, horizons);
+    }
+  }
+  if (populations.empty()) {
+    populations = totalPopulations<PopType, Cycle, Hatching>(lifecycle, init_pop, horizons);
+  }
+  auto t_end = std::chrono::steady_clock::now();
+
+  if (horizons.size() == 1) {
+    std::cout << "final population after " << horizons.front()
+              << " days: " << toString(populations.front()) << std::endl;
+  } else {
+    std::cout << "days,population\n";
+    for (std::size_t i = 0; i < horizons.size(); ++i) {
+      std::cout << horizons[i] << "," << toString(populations[i]) << "\n";
+    }
+  }
+  std::cout << "Execution took "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count()
+            << " ns" << std::endl;
+}
+
+// run the compiled engine matching the lifecycle, or the runtime sized one if there is none
+template <typename PopType, int... Cycles, int... Hatchings>
+void dispatch(std::tuple<CompiledLifecycle<Cycles, Hatchings>...>, const Lifecycle& lifecycle,
+              const std::vector<int>& init_pop, const std::vector<std::int64_t>& horizons,
+              const std::string& engine) {
+  auto runIfMatching = [&](auto cycle, auto hatching) {
+    if (lifecycle.cycle != cycle || lifecycle.hatching != hatching) return false;
+    run<PopType, decltype(cycle)::value, decltype(hatching)::value>(lifecycle, init_pop, horizons,
+                                                                     engine);
+    return true;
+  };
+  bool compiled = (runIfMatching(std::integral_constant<int, Cycles>(),
+                                 std::integral_constant<int, Hatchings>()) ||
+                   ...);
+  if (!compiled) {
+    if (engine == "matrix") std::cout << "No compiled matrix engine, using linear" << std::endl;
+    run<PopType, DYNAMIC, DYNAMIC>(lifecycle, init_pop, horizons, engine);
+  }
+}
+
+template <typename PopType>
+void solve(const Lifecycle& lifecycle, const std::vector<int>& init_pop,
+           const std::vector<std::int64_t>& horizons, const std::string& engine) {
+  dispatch<PopType>(CompiledLifecycles(), lifecycle, init_pop, horizons, engine);
+}
+
+// parse "d", "d1,d2,..." or "first:last[:step]", sorted and without duplicates
+// empty for a range with negative bounds, a step < 1 or more than MAX_HORIZONS days
+std::vector<std::int64_t> parseHorizons(const std::string& arg) {
+  std::vector<std::int64_t> horizons;
+  if (arg.find(':') != std::string::npos) {
+    std::int64_t first = 0;
+    std::int64_t last = 0;
+    std::int64_t step = 1;
+    char separator;
+    std::istringstream iss(arg);
+    iss >> first >> separator >> last;
+    if (iss >> separator) iss >> step;
+
+    // length is checked before anything is expanded
+    if (first < 0 || last < 0 || step < 1) return horizons;
+    if (last >= first && (last - first) / step >= MAX_HORIZONS) return horizons;
+    // stops before days + step could pass last (and overflow)
+    for (std::int64_t days = first; days <= last; days += step) {
+      horizons.push_back(days);
+      if (last - days < step) break;
+    }
+  } else {
+    std::istringstream iss(arg);
+    std::string value;
+    while (std::getline(iss, value, ',')) horizons.push_back(std::stoll(value));
+  }
+
+  std::sort(horizons.begin(), horizons.end());
+  horizons.erase(std::unique(horizons.begin(), horizons.end()), horizons.end());
+  return horizons;
+}
+
+template <typename PopType, int Cycle, int Hatching>
+Rings<PopType, Cycle, Hatching>::Rings(const Lifecycle& lifecycle,
+                                       const std::vector<int>& init_pop) {
+  if constexpr (Cycle == DYNAMIC) next_spawns_.resize(lifecycle.cycle, 0);
+  if constexpr (Hatching == DYNAMIC) next_hatching_.resize(lifecycle.hatching, 0);
+
+  // timer t < cycle spawns on day t + 1, a newborn on day hatching + cycle + 1
+  const int cycle = next_spawns_.size();
+  for (int t = 0; t < int(init_pop.size()); ++t) {
+    if (t < cycle) {
+      next_spawns_[t] = init_pop[t];
+    } else {
+      next_hatching_[t - cycle] = init_pop[t];
+    }
+  }
+}
+
+template <typename PopType, int Cycle, int Hatching>
+void Rings<PopType, Cycle, Hatching>::advance(std::int64_t days) {
+  if constexpr (COMPILED && PERIOD <= MAX_UNROLLED_PERIOD) {
+    // single days until both rings are back at index 0, then whole periods
+    for (; days > 0 && (current_spawn_ != 0 || current_hatching_ != 0); --days) stepDay();
+    for (; days >= PERIOD; days -= PERIOD) advancePeriod(std::make_index_sequence<PERIOD>());
+  }
+  for (; days > 0; --days) stepDay();
+}
+
+template <typename PopType, int Cycle, int Hatching>
+PopType Rings<PopType, Cycle, Hatching>::total() const {
+  PopType population = 0;
+  population += std::accumulate(next_spawns_.cbegin(), next_spawns_.cend(), PopType(0));
+  population += std::accumulate(next_hatching_.cbegin(), next_hatching_.cend(), PopType(0));
+  return population;
+}
+
+template <typename PopType, int Cycle, int Hatching>
+TransitionPowers<PopType, Cycle, Hatching>::TransitionPowers() {
+  // new[t] = M[t][s] * old[s]
+  Matrix one_day = {};
+  for (int t = 0; t < STATES - 1; ++t) one_day[t][t + 1] = 1;  // timers count down
+  one_day[Cycle - 1][0] = 1;                                  // restart cycle
+  one_day[STATES - 1][0] = 1;                                 // newborn
+  powers_.push_back(one_day);
+}
+
+template <typename PopType, int Cycle, int Hatching>
+const typename TransitionPowers<PopType, Cycle, Hatching>::Matrix&
+TransitionPowers<PopType, Cycle, Hatching>::power(int k) {
+  while (int(powers_.size()) <= k) {
+    const Matrix& m = powers_.back();
+    Matrix square = {};
+    for (int i = 0; i < STATES; ++i) {
+      for (int l = 0; l < STATES; ++l) {
+        for (int j = 0; j < STATES; ++j) square[i][j] += m[i][l] * m[l][j];
+      }
+    }
+    powers_.push_back(square);
+  }
+  return powers_[k];
+}
+
+template <typename PopType, int Cycle, int Hatching>
+PopType TransitionPowers<PopType, Cycle, Hatching>::totalPopulation(
+    const std::vector<int>& init_pop, std::int64_t days) {
+  // row vector 1^T, multiplied from the right by the powers for each set bit of days
+  std::array<PopType, STATES> weights;
+  weights.fill(1);
+  for (int k = 0; (days >> k) > 0; ++k) {
+    if (((days >> k) & 1) == 0) continue;
+
+    const Matrix& m = power(k);
+    std::array<PopType, STATES> next = {};
+    for (int i = 0; i < STATES; ++i) {
+      for (int j = 0; j < STATES; ++j) next[j] += weights[i] * m[i][j];
+    }
+    weights = next;
+  }
+
+  PopType final_population = 0;
+  for (int t = 0; t < int(init_pop.size()); ++t) {
+    final_population += weights[t] * PopType(init_pop[t]);
+  }
   return final_population;
 }
 
+template <typename PopType, int Cycle, int Hatching>
+std::vector<PopType> TransitionPowers<PopType, Cycle, Hatching>::totalPopulations(
+    const std::vector<int>& init_pop, const std::vector<std::int64_t>& horizons) {
+  std::vector<PopType> populations;
+  populations.reserve(horizons.size());
+  for (auto days : horizons) populations.push_back(totalPopulation(init_pop, days));
+  return populations;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   if (argc < 3) {
-    std::cout << "Required input arguments: <filename> <num_days>" << std::endl;
+    std::cout << "Required input arguments: <filename> <num_days> [linear|matrix] [cycle] "
+                 "[hatching]"
+              << std::endl;
     return 1;
   }
 
@@ -82,20 +365,55 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  int days = std::atoi(argv[2]);
-  std::array<int, CYCLE> initial_population = readPopulation(ifile);
+  std::vector<std::int64_t> horizons = parseHorizons(argv[2]);
+  if (horizons.empty() || horizons.front() < 0) {
+    std::cout << "Invalid number of days " << argv[2] << " (at most " << MAX_HORIZONS
+              << " horizons)" << std::endl;
+    return 1;
+  }
+  std::string engine = (argc > 3) ? argv[3] : "linear";
+  if (engine != "linear" && engine != "matrix") {
+    std::cout << "Unknown engine " << engine << std::endl;
+    return 1;
+  }
+  Lifecycle lifecycle;
+  if (argc > 4) lifecycle.cycle = std::atoi(argv[4]);
+  if (argc > 5) lifecycle.hatching = std::atoi(argv[5]);
+  if (lifecycle.cycle < 1 || lifecycle.hatching < 1) {
+    std::cout << "Cycle and hatching must be at least 1 day" << std::endl;
+    return 1;
+  }
+
+  std::vector<int> initial_population = readPopulation(ifile);
+  if (int(initial_population.size()) > lifecycle.states()) {
+    std::cout << "Timer " << initial_population.size() - 1 << " exceeds lifecycle" << std::endl;
+    return 1;
+  }
 
   //  std::cout << "Initial population: " << std::endl;
   //  for (auto i : initial_population) std::cout << i << ", ";
   //  std::cout << std::endl;
 
-  auto t_start = std::chrono::steady_clock::now();
-  PopType total_population = totalPopulation(initial_population, days);
-  auto t_end = std::chrono::steady_clock::now();
-  std::cout << "final population after " << days << " days: " << total_population << std::endl;
-  std::cout << "Execution took "
-            << std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count()
-            << " ns" << std::endl;
+  std::int64_t num_bits = upperBoundBits(initial_population, lifecycle.cycle, horizons.back());
+  if (num_bits <= 64) {
+    solve<std::uint64_t>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 128) {
+    solve<uint128>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 256) {
+    solve<WideUInt<4>>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 512) {
+    solve<WideUInt<8>>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 1024) {
+    solve<WideUInt<16>>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 2048) {
+    solve<WideUInt<32>>(lifecycle, initial_population, horizons, engine);
+  } else if (num_bits <= 4096) {
+    solve<WideUInt<64>>(lifecycle, initial_population, horizons, engine);
+  } else {
+    std::cout << "Number too big, will overflow!" << std::endl;
+    std::cout << "Upper bound has " << num_bits << " bits > 4096" << std::endl;
+    return 1;
+  }
 
   return 0;
 }
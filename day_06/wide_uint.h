@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Fixed width unsigned integers for population counts beyond 64 bit
+//
+// uint128 is the compiler's native 128-bit type. WideUInt<N> stores N 64-bit limbs, least
+// significant first. Only what the population engines need is provided: construction from
+// small values, addition, multiplication (both modulo 2^(64 N), like the builtin types) and
+// conversion to decimal. Addition loops over all N limbs, a fixed trip count the compiler can
+// unroll. Multiplication only loops over the limbs up to the highest non-zero one of each
+// operand, so its trip counts depend on the values: small populations in a wide type only
+// pay for the limbs they use.
+
+using uint128 = unsigned __int128;
+
+template <int N>
+class WideUInt {
+ public:
+  constexpr WideUInt() = default;
+  constexpr WideUInt(std::uint64_t value) { limbs_[0] = value; }
+
+  WideUInt& operator+=(const WideUInt& other) {
+    std::uint64_t carry = 0;
+    for (int i = 0; i < N; ++i) {
+      uint128 sum = uint128(limbs_[i]) + other.limbs_[i] + carry;
+      limbs_[i] = std::uint64_t(sum);
+      carry = std::uint64_t(sum >> 64);
+    }
+    return *this;
+  }
+
+  friend WideUInt operator+(WideUInt a, const WideUInt& b) { return a += b; }
+
+  // schoolbook multiplication, truncated to N limbs
+  friend WideUInt operator*(const WideUInt& a, const WideUInt& b) {
+    WideUInt result;
+    const int a_size = a.size();
+    const int b_size = b.size();
+    for (int i = 0; i < a_size; ++i) {
+      std::uint64_t carry = 0;
+      for (int j = 0; j < std::min(b_size, N - i); ++j) {
+        uint128 cur = uint128(a.limbs_[i]) * b.limbs_[j] + result.limbs_[i + j] + carry;
+        result.limbs_[i + j] = std::uint64_t(cur);
+        carry = std::uint64_t(cur >> 64);
+      }
+      if (i + b_size < N) result.limbs_[i + b_size] = carry;
+    }
+    return result;
+  }
+
+  WideUInt& operator*=(const WideUInt& other) { return *this = *this * other; }
+
+  bool isZero() const { return size() == 0; }
+
+  // divide by a 64-bit value in place, return remainder
+  std::uint64_t divmod(std::uint64_t divisor) {
+    uint128 remainder = 0;
+    for (int i = N - 1; i >= 0; --i) {
+      uint128 cur = (remainder << 64) | limbs_[i];
+      limbs_[i] = std::uint64_t(cur / divisor);
+      remainder = cur % divisor;
+    }
+    return std::uint64_t(remainder);
+  }
+
+ private:
+  // number of limbs up to the highest non-zero one
+  int size() const {
+    int size = N;
+    while (size > 0 && limbs_[size - 1] == 0) --size;
+    return size;
+  }
+
+  std::array<std::uint64_t, N> limbs_ = {};
+};
+
+inline std::string toString(std::uint64_t value) { return std::to_string(value); }
+
+inline std::string toString(uint128 value) {
+  std::string digits;
+  do {
+    digits += char('0' + int(value % 10));
+    value /= 10;
+  } while (value > 0);
+
+  std::reverse(digits.begin(), digits.end());
+  return digits;
+}
+
+// 19 decimal digits per division
+template <int N>
+std::string toString(WideUInt<N> value) {
+  static constexpr std::uint64_t chunk = 10000000000000000000ull;  // 10^19
+
+  std::string digits;
+  while (true) {
+    std::uint64_t part = value.divmod(chunk);
+    if (value.isZero()) {  // leading chunk, no zero padding
+      do {
+        digits += char('0' + part % 10);
+        part /= 10;
+      } while (part > 0);
+      break;
+    }
+
+    for (int i = 0; i < 19; ++i, part /= 10) digits += char('0' + part % 10);
+  }
+
+  std::reverse(digits.begin(), digits.end());
+  return digits;
+}
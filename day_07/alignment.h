@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Generic crab alignment solver
+//
+// The fuel of a crab only depends on its distance d to the target, through a cost policy:
+//
+//   struct Cost {
+//     static constexpr bool CONVEX = ...;             // cost(d) convex in d
+//     std::uint64_t operator()(std::uint32_t d) const;
+//   };
+//
+// The total fuel F(x) = sum(w_i * cost(|pos_i - x|)) is then convex in x as well (a sum of
+// convex functions of |pos_i - x| with w_i >= 0), so the optimum is found by ternary search
+// over the integer positions between the first and last crab, O(N log(range)). Costs that
+// are not convex (e.g. capped) fall back to evaluating every position, O(N range).
+//
+// The fuel kernel is a plain loop over packed 32 bit positions with 64 bit accumulation and
+// the cost inlined, which the compiler vectorizes at -O3 (SSE2 by default, -mavx2 or
+// -mavx512f for wider vectors). Several targets are evaluated per pass: every target runs
+// over a chunk of crabs that stays in L1 before the next chunk is loaded, so the ternary
+// search reads the crabs from memory once per step for both of its probes, and the full
+// scan once per FUEL_BLOCK positions. With num_threads > 1 the crabs are
+// split into contiguous ranges, each thread sums its own range and the partial fuels are
+// added up at the end.
+//
+namespace crab_alignment {
+
+struct Crabs {
+  std::vector<std::int32_t> positions;
+  std::vector<std::int32_t> weights;  // per crab fuel factor, empty if all are 1
+};
+
+struct Alignment {
+  int position;
+  std::size_t fuel;
+};
+
+// part 1 : one fuel per step
+struct AbsoluteDistance {
+  static constexpr bool CONVEX = true;
+  std::uint64_t operator()(std::uint32_t distance) const { return distance; }
+};
+
+// part 2 : 1 + 2 + ... + d
+struct TriangularDistance {
+  static constexpr bool CONVEX = true;
+  std::uint64_t operator()(std::uint32_t distance) const {
+    // 32 x 32 -> 64 bit products vectorize, d (d + 1) written out as d^2 + d does not
+    return (std::uint64_t(distance) * std::uint32_t(distance + 1)) >> 1;
+  }
+};
+
+struct QuadraticDistance {
+  static constexpr bool CONVEX = true;
+  std::uint64_t operator()(std::uint32_t distance) const {
+    return std::uint64_t(distance) * distance;
+  }
+};
+
+// one fuel per step, but never more than cap : concave beyond cap, needs the full scan
+struct CappedDistance {
+  static constexpr bool CONVEX = false;
+  std::uint64_t cap;
+  std::uint64_t operator()(std::uint32_t distance) const {
+    return std::min(std::uint64_t(distance), cap);
+  }
+};
+
+static constexpr int FUEL_BLOCK = 4;       // targets per pass of the full scan
+static constexpr std::size_t CHUNK = 4096;  // crabs per chunk, 16 kB of positions stay in L1
+
+// distance as unsigned 32 bit, without sign extension the costs use widening products
+// the subtraction is done unsigned, so spreads beyond INT32_MAX do not overflow
+inline std::uint32_t distance(std::int32_t position, std::int32_t target) {
+  const std::uint32_t p = position;
+  const std::uint32_t t = target;
+  return position > target ? p - t : t - p;
+}
+
+// fuel of crabs [begin, end) at a single target, the vectorized loop
+template <typename Cost>
+std::uint64_t chunkFuel(const Crabs& crabs, std::int32_t target, const Cost& cost,
+                        std::size_t begin, std::size_t end) {
+  const std::int32_t* positions = crabs.positions.data();
+
+  std::uint64_t fuel = 0;
+  if (crabs.weights.empty()) {
+    for (std::size_t i = begin; i < end; ++i) {
+      fuel += cost(distance(positions[i], target));
+    }
+  } else {
+    const std::int32_t* weights = crabs.weights.data();
+    for (std::size_t i = begin; i < end; ++i) {
+      fuel += std::uint64_t(weights[i]) * cost(distance(positions[i], target));
+    }
+  }
+  return fuel;
+}
+
+// fuel of crabs [begin, end) for each target
+// all targets are evaluated on a chunk before moving on, so the crabs are read from memory
+// once, while every target still gets its own single accumulator loop
+template <int NumTargets, typename Cost>
+std::array<std::uint64_t, NumTargets> partialFuels(
+    const Crabs& crabs, const std::array<std::int32_t, NumTargets>& targets, const Cost& cost,
+    std::size_t begin, std::size_t end) {
+  std::array<std::uint64_t, NumTargets> fuels = {};
+  for (std::size_t chunk = begin; chunk < end; chunk += CHUNK) {
+    const std::size_t chunk_end = std::min(chunk + CHUNK, end);
+    for (int t = 0; t < NumTargets; ++t) {
+      fuels[t] += chunkFuel(crabs, targets[t], cost, chunk, chunk_end);
+    }
+  }
+  return fuels;
+}
+
+// total fuel to align all crabs at each of the targets
+template <int NumTargets, typename Cost>
+std::array<std::uint64_t, NumTargets> totalFuels(
+    const Crabs& crabs, const std::array<std::int32_t, NumTargets>& targets, const Cost& cost,
+    int num_threads = 1) {
+  const std::size_t num_crabs = crabs.positions.size();
+  if (num_threads <= 1) return partialFuels<NumTargets>(crabs, targets, cost, 0, num_crabs);
+
+  // one cache line per thread, so the partial results never share one
+  struct alignas(64) Partial {
+    std::array<std::uint64_t, NumTargets> fuels;
+  };
+  std::vector<Partial> partials(num_threads);
+
+  auto sumRange = [&](int thread) {
+    const std::size_t begin = num_crabs * thread / num_threads;
+    const std::size_t end = num_crabs * (thread + 1) / num_threads;
+    partials[thread].fuels = partialFuels<NumTargets>(crabs, targets, cost, begin, end);
+  };
+
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < num_threads; ++thread) threads.emplace_back(sumRange, thread);
+  sumRange(0);
+  for (auto& thread : threads) thread.join();
+
+  std::array<std::uint64_t, NumTargets> fuels = {};
+  for (const auto& partial : partials) {
+    for (int t = 0; t < NumTargets; ++t) fuels[t] += partial.fuels[t];
+  }
+  return fuels;
+}
+
+// total fuel to align all crabs at target
+template <typename Cost>
+std::uint64_t totalFuel(const Crabs& crabs, std::int32_t target, const Cost& cost,
+                        int num_threads = 1) {
+  return totalFuels<1>(crabs, {target}, cost, num_threads)[0];
+}
+
+// optimal target position (lowest one on ties) and its fuel, crabs must not be empty
+template <typename Cost>
+Alignment align(const Crabs& crabs, const Cost& cost = Cost(), int num_threads = 1) {
+  auto [min_it, max_it] = std::minmax_element(crabs.positions.cbegin(), crabs.positions.cend());
+  std::int32_t lo = *min_it;
+  std::int32_t hi = *max_it;
+
+  if constexpr (Cost::CONVEX) {
+    // keeps the lowest optimum in [lo, hi] : on ties, convexity puts one in [m1, m2]
+    // the span is 64 bit, positions may cover the whole int32 range
+    while (std::int64_t(hi) - lo > 2) {
+      const std::int32_t third = (std::int64_t(hi) - lo) / 3;
+      std::int32_t m1 = lo + third;
+      std::int32_t m2 = hi - third;
+      auto [fuel_1, fuel_2] = totalFuels<2>(crabs, {m1, m2}, cost, num_threads);
+      if (fuel_1 <= fuel_2) {
+        hi = m2;
+      } else {
+        lo = m1 + 1;
+      }
+    }
+  }
+
+  // blocks of FUEL_BLOCK positions, targets past hi repeat hi and never win
+  Alignment best = {lo, std::numeric_limits<std::size_t>::max()};
+  for (std::int64_t x = lo; x <= hi; x += FUEL_BLOCK) {
+    std::array<std::int32_t, FUEL_BLOCK> targets;
+    for (int t = 0; t < FUEL_BLOCK; ++t) targets[t] = std::min<std::int64_t>(x + t, hi);
+
+    auto fuels = totalFuels<FUEL_BLOCK>(crabs, targets, cost, num_threads);
+    for (int t = 0; t < FUEL_BLOCK; ++t) {
+      if (fuels[t] < best.fuel) best = {targets[t], fuels[t]};
+    }
+  }
+  return best;
+}
+
+}  // namespace crab_alignment
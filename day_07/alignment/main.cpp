@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../alignment.h"
+
+// Alignment with any of the cost policies of alignment.h
+//
+// <cost>    : absolute, triangular, quadratic or capped:<cap>
+// [weights] : optional file with one fuel factor per crab, same format as the positions
+//
+namespace {
+
+std::vector<std::int32_t> readValues(std::ifstream& ifile);
+
+template <typename Cost>
+void run(const crab_alignment::Crabs& crabs, const Cost& cost);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "Required input arguments: <filename> "
+                 "<absolute|triangular|quadratic|capped:<cap>> [weights_file]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  std::ifstream ifile(filename);
+
+  if (!ifile.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  crab_alignment::Crabs crabs;
+  crabs.positions = readValues(ifile);
+  if (crabs.positions.empty()) {
+    std::cout << "No crabs found" << std::endl;
+    return 1;
+  }
+
+  if (argc > 3) {
+    std::ifstream wfile(argv[3]);
+    if (!wfile.good()) {
+      std::cout << "Could not open " << argv[3] << std::endl;
+      return 1;
+    }
+    crabs.weights = readValues(wfile);
+    if (crabs.weights.size() != crabs.positions.size()) {
+      std::cout << "Expected " << crabs.positions.size() << " weights, got "
+                << crabs.weights.size() << std::endl;
+      return 1;
+    }
+  }
+
+  std::string cost = argv[2];
+  if (cost == "absolute") {
+    run(crabs, crab_alignment::AbsoluteDistance());
+  } else if (cost == "triangular") {
+    run(crabs, crab_alignment::TriangularDistance());
+  } else if (cost == "quadratic") {
+    run(crabs, crab_alignment::QuadraticDistance());
+  } else if (cost.rfind("capped:", 0) == 0) {
+    run(crabs, crab_alignment::CappedDistance{std::strtoull(cost.c_str() + 7, nullptr, 10)});
+  } else {
+    std::cout << "Unknown cost " << cost << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+namespace {
+
+std::vector<std::int32_t> readValues(std::ifstream& ifile) {
+  std::vector<std::int32_t> values;
+  std::int32_t value;
+  while (ifile >> value) {
+    values.push_back(value);
+    ifile.get();  // skip comma
+  }
+  return values;
+}
+
+template <typename Cost>
+void run(const crab_alignment::Crabs& crabs, const Cost& cost) {
+  auto t_start = std::chrono::steady_clock::now();
+  auto [optimal_position, fuel] = crab_alignment::align(crabs, cost);
+  auto t_end = std::chrono::steady_clock::now();
+
+  std::cout << "Optimal target position is at " << optimal_position << ", fuel cost is " << fuel
+            << std::endl;
+  std::cout << "Execution took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()
+            << " us" << std::endl;
+}
+
+}  // namespace
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../alignment.h"
+
+// Benchmark of the fuel kernel of alignment.h against the loop of puzzle_02
+//
+// Random crabs in [0, max_position) are evaluated at NUM_TARGETS targets around the mean:
+//
+// scalar  : computeFuel of puzzle_02, one pass over the crabs per target
+// kernel  : totalFuels, FUEL_BLOCK targets per pass, single thread
+// threads : totalFuels with num_threads threads
+//
+// Build with -O3 (and -mavx2 / -mavx512f) to get the vectorized kernel.
+//
+namespace {
+
+static constexpr int NUM_TARGETS = 8;
+
+// as in puzzle_02
+std::size_t computeFuel(const std::vector<int>& positions, int target_position) {
+  std::size_t fuel = 0;
+  for (auto pos : positions) {
+    int distance = std::abs(pos - target_position);
+    fuel += (distance + 1) * distance;
+  }
+  fuel = fuel / 2;
+  return fuel;
+}
+
+template <typename Function>
+void measure(const char* label, std::size_t num_crabs, Function&& function) {
+  auto t_start = std::chrono::steady_clock::now();
+  std::array<std::uint64_t, NUM_TARGETS> fuels = function();
+  auto t_end = std::chrono::steady_clock::now();
+
+  const double ns = std::chrono::duration<double, std::nano>(t_end - t_start).count();
+  std::cout << label << ": " << std::uint64_t(ns / 1000) << " us, "
+            << ns / (double(num_crabs) * NUM_TARGETS) << " ns per crab and target, fuels";
+  for (auto fuel : fuels) std::cout << " " << fuel;
+  std::cout << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <num_crabs> [num_threads] [max_position]"
+              << std::endl;
+    return 1;
+  }
+
+  const std::size_t num_crabs = std::stoull(argv[1]);
+  const int num_threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+  const int max_position = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+  // fuel of a single crab must fit the int arithmetic of computeFuel
+  if (num_crabs == 0 || max_position < 1 || max_position > 46000) {
+    std::cout << "Need at least one crab and max_position in 1 - 46000" << std::endl;
+    return 1;
+  }
+
+  crab_alignment::Crabs crabs;
+  crabs.positions.resize(num_crabs);
+  std::mt19937 generator(2021);
+  std::uniform_int_distribution<std::int32_t> distribution(0, max_position - 1);
+  for (auto& position : crabs.positions) position = distribution(generator);
+
+  std::array<std::int32_t, NUM_TARGETS> targets;
+  for (int t = 0; t < NUM_TARGETS; ++t) targets[t] = max_position / 2 - NUM_TARGETS / 2 + t;
+  std::cout << "Evaluating " << num_crabs << " crabs at " << NUM_TARGETS << " targets"
+            << std::endl;
+
+  const crab_alignment::TriangularDistance cost;
+  measure("scalar ", num_crabs, [&] {
+    std::array<std::uint64_t, NUM_TARGETS> fuels;
+    for (int t = 0; t < NUM_TARGETS; ++t) fuels[t] = computeFuel(crabs.positions, targets[t]);
+    return fuels;
+  });
+
+  auto blocks = [&](int threads) {
+    std::array<std::uint64_t, NUM_TARGETS> fuels;
+    for (int t = 0; t < NUM_TARGETS; t += crab_alignment::FUEL_BLOCK) {
+      std::array<std::int32_t, crab_alignment::FUEL_BLOCK> block;
+      std::copy_n(targets.cbegin() + t, block.size(), block.begin());
+      auto block_fuels =
+          crab_alignment::totalFuels<crab_alignment::FUEL_BLOCK>(crabs, block, cost, threads);
+      std::copy(block_fuels.cbegin(), block_fuels.cend(), fuels.begin() + t);
+    }
+    return fuels;
+  };
+  measure("kernel ", num_crabs, [&] { return blocks(1); });
+  measure("threads", num_crabs, [&] { return blocks(std::max(num_threads, 1)); });
+
+  return 0;
+}
@@ -7,6 +7,8 @@
 #include <string>
 #include <vector>
 
+#include "../alignment.h"
+
 //
 // In general, this is an integer linear programming problem, but
 // maybe we can brute force it fairly easily
@@ -23,10 +25,38 @@
 //
 // corner case: even number of crabs -> either side is fine
 //
+// Engines (second argument, default median):
+//
+// median : nth_element, then one pass for the fuel
+// convex : generic ternary search of alignment.h with the absolute distance cost
+//
+
+namespace {
+
+// reorders positions
+crab_alignment::Alignment medianAlignment(std::vector<int>& positions) {
+  std::size_t num_crabs = positions.size();
+  auto m_it = positions.begin() + (0.5 * num_crabs);
+  std::nth_element(positions.begin(), m_it, positions.end());  // sort up to m'th element
+  int optimal_position = *m_it;
+
+  std::size_t fuel = 0;
+  auto it = positions.cbegin();
+  for (; it != m_it; ++it) {
+    fuel += (optimal_position - *it);
+  }
+  for (; it != positions.cend(); ++it) {
+    fuel += (*it - optimal_position);
+  }
+
+  return {optimal_position, fuel};
+}
+
+}  // namespace
 
 int main(int argc, char** argv) {
   if (argc < 2) {
-    std::cout << "Required input arguments: <filename>" << std::endl;
+    std::cout << "Required input arguments: <filename> [median|convex]" << std::endl;
     return 1;
   }
 
@@ -38,6 +68,12 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  std::string engine = (argc > 2) ? argv[2] : "median";
+  if (engine != "median" && engine != "convex") {
+    std::cout << "Unknown engine " << engine << std::endl;
+    return 1;
+  }
+
   // insertion could be optimized
   auto t_start = std::chrono::steady_clock::now();
   std::vector<int> positions;
@@ -47,19 +83,15 @@ int main(int argc, char** argv) {
     ifile.get();
   }
 
-  std::size_t num_crabs = positions.size();
-  auto m_it = positions.begin() + (0.5 * num_crabs);
-  std::nth_element(positions.begin(), m_it, positions.end());  // sort up to m'th element
-  int optimal_position = *m_it;
-
-  std::size_t fuel = 0;
-  auto it = positions.cbegin();
-  for (; it != m_it; ++it) {
-    fuel += (optimal_position - *it);
-  }
-  for (; it != positions.cend(); ++it) {
-    fuel += (*it - optimal_position);
+  if (positions.empty()) {
+    std::cout << "No crabs found" << std::endl;
+    return 1;
   }
+
+  auto [optimal_position, fuel] =
+      (engine == "median")
+          ? medianAlignment(positions)
+          : crab_alignment::align<crab_alignment::AbsoluteDistance>({positions, {}});
   auto t_end = std::chrono::steady_clock::now();
 
   std::cout << "Possible Optimal target position is at " << optimal_position << ", fuel cost is "
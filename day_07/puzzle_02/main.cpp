@@ -1,14 +1,18 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <string>
 #include <vector>
 
 #include <iomanip>
 
+#include "../alignment.h"
+
 //
 // This would be a constrained integer quadratic programming problem
 //
@@ -38,11 +42,31 @@
 // x_optimum = floor(sum_tot(pos_i) / Ntot)
 //
 // Note : The above appears to be incorrect, require search in vicinity of mean
-//        Reason TBD
+//        Reason: the step from x-1 to x also contains the "+ 1" part of the triangle,
+//        f(x) - f(x-1) = Ntot * x - sum_tot(pos_i) - NB, which moves the optimum by up to
+//        1/2 away from the mean, to whichever side has more crabs
+//
+// Engines (second argument, default histogram):
+//
+// search    : start at the mean and walk towards the lower fuel, up to 100 steps
+// convex    : generic ternary search of alignment.h with the triangular cost
+// histogram : exact, no search. With d = |pos_i - x|, f(x) = (sum(d^2) + sum(d)) / 2 where
+//
+//               sum(d^2) = sum(pos_i^2) - 2 x sum(pos_i) + Ntot x^2
+//               sum(d)   = (NA x - sum_A(pos_i)) + (sum_B(pos_i) - NB x)
+//
+//             NA and sum_A are prefix sums over a histogram of the positions, so every
+//             integer x between the first and last crab is evaluated in O(1), O(N + range)
+//             in total. The optimum of a convex cost lies within that range. Crabs spread
+//             over more than MAX_HISTOGRAM_RANGE positions use the convex engine instead.
 //
 
 namespace {
 
+using crab_alignment::Alignment;
+
+static constexpr std::int64_t MAX_HISTOGRAM_RANGE = std::int64_t(1) << 24;  // 128 MB of counts
+
 std::size_t computeFuel(const std::vector<int>& positions, int target_position) {
   std::size_t fuel = 0;
   for (auto pos : positions) {
@@ -53,11 +77,79 @@ std::size_t computeFuel(const std::vector<int>& positions, int target_position)
   return fuel;
 }
 
+// start at the mean and walk downhill, bounded to 100 steps
+Alignment searchAlignment(const std::vector<int>& positions, std::size_t sum) {
+  // This is restricted to integer locations
+  int optimal_position = sum / positions.size();
+  std::size_t fuel = computeFuel(positions, optimal_position);
+
+  // search for optimum in vicinity, see note above for why this is needed
+  std::size_t tmp_fuel = computeFuel(positions, optimal_position + 1);
+  if (fuel > tmp_fuel) {
+    for (int i = 2; (i < 100) && (fuel > tmp_fuel); ++i) {
+      fuel = tmp_fuel;  // found new minimum!
+      ++optimal_position;
+
+      tmp_fuel = computeFuel(positions, optimal_position + i);
+    }
+  } else {
+    tmp_fuel = computeFuel(positions, optimal_position - 1);
+    for (int i = 2; (i < 100) && (fuel > tmp_fuel); ++i) {
+      fuel = tmp_fuel;  // found new minimum!
+      --optimal_position;
+
+      tmp_fuel = computeFuel(positions, optimal_position - i);
+    }
+  }
+
+  return {optimal_position, fuel};
+}
+
+// number of positions between first and last crab, 64 bit as crabs may span the int range
+std::int64_t positionRange(const std::vector<int>& positions) {
+  auto [min_it, max_it] = std::minmax_element(positions.cbegin(), positions.cend());
+  return std::int64_t(*max_it) - *min_it + 1;
+}
+
+// exact optimum, evaluating all positions between first and last crab (lowest one on ties)
+// the range must be at most MAX_HISTOGRAM_RANGE
+Alignment histogramAlignment(const std::vector<int>& positions) {
+  const int offset = *std::min_element(positions.cbegin(), positions.cend());
+  const std::int64_t range = positionRange(positions);  // work with pos_i - offset
+
+  std::vector<std::int64_t> counts(range, 0);
+  for (auto pos : positions) ++counts[pos - offset];
+
+  std::int64_t num_crabs = positions.size();
+  std::int64_t sum_total = 0;
+  std::int64_t sum_squares = 0;
+  for (std::int64_t x = 0; x < range; ++x) {
+    sum_total += counts[x] * x;
+    sum_squares += counts[x] * x * x;
+  }
+
+  Alignment best = {offset, std::numeric_limits<std::size_t>::max()};
+  std::int64_t count_below = 0;  // NA, crabs left of x
+  std::int64_t sum_below = 0;    // sum_A(pos_i)
+  for (std::int64_t x = 0; x < range; ++x) {
+    std::int64_t squares = sum_squares - 2 * x * sum_total + num_crabs * x * x;
+    std::int64_t distances = (count_below * x - sum_below) +
+                             ((sum_total - sum_below) - (num_crabs - count_below) * x);
+    std::size_t fuel = (squares + distances) / 2;
+    if (fuel < best.fuel) best = {int(x) + offset, fuel};
+
+    count_below += counts[x];
+    sum_below += counts[x] * x;
+  }
+
+  return best;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   if (argc < 2) {
-    std::cout << "Required input arguments: <filename>" << std::endl;
+    std::cout << "Required input arguments: <filename> [histogram|search|convex]" << std::endl;
     return 1;
   }
 
@@ -69,6 +161,12 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  std::string engine = (argc > 2) ? argv[2] : "histogram";
+  if (engine != "histogram" && engine != "search" && engine != "convex") {
+    std::cout << "Unknown engine " << engine << std::endl;
+    return 1;
+  }
+
   // insertion could be optimized
   auto t_start = std::chrono::steady_clock::now();
   std::vector<int> positions;
@@ -80,6 +178,11 @@ int main(int argc, char** argv) {
     ifile.get();
   }
 
+  if (positions.empty()) {
+    std::cout << "No crabs found" << std::endl;
+    return 1;
+  }
+
   // this should be the theoretically optimal position
   {
     double optimal_position_d = static_cast<double>(sum) / positions.size();
@@ -96,28 +199,21 @@ int main(int argc, char** argv) {
     }
   }
 
-  // This is restricted to integer locations
-  int optimal_position = sum / positions.size();
-  std::size_t fuel = computeFuel(positions, optimal_position);
-
-  // search for optimum in vicinity (why is this needed??)
-  std::size_t tmp_fuel = computeFuel(positions, optimal_position + 1);
-  if (fuel > tmp_fuel) {
-    for (int i = 2; (i < 100) && (fuel > tmp_fuel); ++i) {
-      fuel = tmp_fuel;  // found new minimum!
-      ++optimal_position;
+  if (engine == "histogram" && positionRange(positions) > MAX_HISTOGRAM_RANGE) {
+    std::cout << "Crabs spread over more than " << MAX_HISTOGRAM_RANGE
+              << " positions, using convex" << std::endl;
+    engine = "convex";
+  }
 
-      tmp_fuel = computeFuel(positions, optimal_position + i);
-    }
+  Alignment alignment;
+  if (engine == "histogram") {
+    alignment = histogramAlignment(positions);
+  } else if (engine == "search") {
+    alignment = searchAlignment(positions, sum);
   } else {
-    tmp_fuel = computeFuel(positions, optimal_position - 1);
-    for (int i = 2; (i < 100) && (fuel > tmp_fuel); ++i) {
-      fuel = tmp_fuel;  // found new minimum!
-      --optimal_position;
-
-      tmp_fuel = computeFuel(positions, optimal_position - i);
-    }
+    alignment = crab_alignment::align<crab_alignment::TriangularDistance>({positions, {}});
   }
+  auto [optimal_position, fuel] = alignment;
   auto t_end = std::chrono::steady_clock::now();
 
   std::cout << "Possible Optimal target position is at " << optimal_position << ", fuel cost is "
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../alignment.h"
+
+// Online version: crab positions arrive as a stream of updates, "pos" adds a crab and
+// "-pos" removes one (separated by commas, spaces or new lines). Every [report_every]
+// updates, and once at the end, the current optimum of both parts is printed.
+//
+// Crabs are counted in a binary trie over the 31 bits of the positions: every node holds the
+// number of crabs and the sum of their positions in its range, and nodes are only created
+// along the paths of positions that occur. Memory is O(31) nodes per distinct position,
+// whatever the size of the positions, and prefix counts and sums take one descent:
+//
+// part 1 : the median is found by descending with the counts, and the fuel is
+//          (NA x - sum_A(pos_i)) + (sum_B(pos_i) - NB x) with A / B the crabs left / right of x
+// part 2 : with d = |pos_i - x|, f(x) = (sum(d^2) + sum(d)) / 2 where sum(d^2) only needs the
+//          running totals of count, position and position squared, and sum(d) is the part 1
+//          formula. f is convex and its real minimum is within 1/2 of the mean (see
+//          puzzle_02), so the integer optimum is one of floor(mean) - 1 ... floor(mean) + 2
+//
+// Updates and both queries are O(31). Positions must be >= 0. Nodes of positions whose
+// crabs were all removed stay allocated and are reused when a crab arrives there again.
+//
+namespace {
+
+class OnlineAlignment {
+ public:
+  void insert(int position);
+
+  // returns false if there is no crab at position
+  bool remove(int position);
+
+  // part 1, target is the median (upper one for an even number of crabs)
+  crab_alignment::Alignment absoluteAlignment() const;
+
+  // part 2, lowest optimal target
+  crab_alignment::Alignment triangularAlignment() const;
+
+  std::int64_t size() const;
+
+ private:
+  static constexpr int NUM_BITS = 31;  // all non-negative int positions
+
+  struct Node {
+    std::int64_t count = 0;  // crabs in the range of the node
+    std::int64_t sum = 0;    // and the sum of their positions
+    std::array<std::uint32_t, 2> children = {0, 0};  // 0 : none, the root is never a child
+  };
+
+  struct Prefix {
+    std::int64_t count = 0;
+    std::int64_t sum = 0;
+  };
+
+  void update(int position, std::int64_t count);
+
+  // number and position sum of crabs at positions < end
+  Prefix below(std::int64_t end) const;
+
+  // sum(|pos_i - x|)
+  std::int64_t distances(std::int64_t x) const;
+
+  std::vector<Node> nodes_ = std::vector<Node>(1);  // root covers [0, 2^NUM_BITS)
+  std::int64_t total_count_ = 0;
+  std::int64_t total_sum_ = 0;
+  std::uint64_t total_squares_ = 0;  // modulo 2^64, see triangularAlignment
+};
+
+void streamAlignment(std::ifstream& ifile, std::size_t report_every);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <filename> [report_every]" << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  std::ifstream ifile(filename);
+  std::size_t report_every = argc > 2 ? std::stoul(argv[2]) : 0;
+
+  if (!ifile.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  streamAlignment(ifile, report_every);
+
+  return 0;
+}
+
+namespace {
+
+void OnlineAlignment::insert(int position) { update(position, 1); }
+
+bool OnlineAlignment::remove(int position) {
+  if (position < 0) return false;
+
+  std::uint32_t node = 0;
+  for (int level = NUM_BITS - 1; level >= 0; --level) {
+    node = nodes_[node].children[(position >> level) & 1];
+    if (node == 0) return false;
+  }
+  if (nodes_[node].count == 0) return false;
+
+  update(position, -1);
+  return true;
+}
+
+crab_alignment::Alignment OnlineAlignment::absoluteAlignment() const {
+  if (total_count_ == 0) return {-1, 0};
+
+  // descend to the leaf holding crab k (0-based, in position order), k = N / 2
+  std::int64_t k = total_count_ / 2;
+  std::uint32_t node = 0;
+  int median = 0;
+  for (int level = NUM_BITS - 1; level >= 0; --level) {
+    const std::uint32_t left = nodes_[node].children[0];
+    const std::int64_t left_count = left != 0 ? nodes_[left].count : 0;
+    if (k < left_count) {
+      node = left;
+    } else {
+      k -= left_count;
+      median |= 1 << level;
+      node = nodes_[node].children[1];
+    }
+  }
+
+  return {median, std::size_t(distances(median))};
+}
+
+crab_alignment::Alignment OnlineAlignment::triangularAlignment() const {
+  if (total_count_ == 0) return {-1, 0};
+
+  // sum(d^2) is computed modulo 2^64 : intermediate terms exceed 64 bit for positions near
+  // INT_MAX, the result is exact whenever the fuel itself fits
+  const std::int64_t mean = total_sum_ / total_count_;
+  crab_alignment::Alignment best = {-1, 0};
+  for (std::int64_t x = std::max<std::int64_t>(mean - 1, 0); x <= mean + 2; ++x) {
+    const std::uint64_t ux = x;
+    std::uint64_t squares = total_squares_ - 2 * ux * std::uint64_t(total_sum_) +
+                            std::uint64_t(total_count_) * ux * ux;
+    std::size_t fuel = (squares + std::uint64_t(distances(x))) / 2;
+    if (best.position < 0 || fuel < best.fuel) best = {int(x), fuel};
+  }
+  return best;
+}
+
+std::int64_t OnlineAlignment::size() const { return total_count_; }
+
+void OnlineAlignment::update(int position, std::int64_t count) {
+  total_count_ += count;
+  total_sum_ += count * position;
+  total_squares_ += std::uint64_t(count) * std::uint64_t(position) * std::uint64_t(position);
+
+  std::uint32_t node = 0;
+  for (int level = NUM_BITS - 1; level >= 0; --level) {
+    nodes_[node].count += count;
+    nodes_[node].sum += count * position;
+
+    const int bit = (position >> level) & 1;
+    if (nodes_[node].children[bit] == 0) {
+      nodes_[node].children[bit] = nodes_.size();
+      nodes_.emplace_back();  // invalidates references into nodes_, only indices are kept
+    }
+    node = nodes_[node].children[bit];
+  }
+  nodes_[node].count += count;  // leaf, a single position
+  nodes_[node].sum += count * position;
+}
+
+OnlineAlignment::Prefix OnlineAlignment::below(std::int64_t end) const {
+  if (end <= 0) return {};
+  if (end >= (std::int64_t(1) << NUM_BITS)) return {total_count_, total_sum_};
+
+  // every right turn on the path to end adds the left sibling
+  Prefix prefix;
+  std::uint32_t node = 0;
+  for (int level = NUM_BITS - 1; level >= 0; --level) {
+    const auto& children = nodes_[node].children;
+    if ((end >> level) & 1) {
+      if (children[0] != 0) {
+        prefix.count += nodes_[children[0]].count;
+        prefix.sum += nodes_[children[0]].sum;
+      }
+      node = children[1];
+    } else {
+      node = children[0];
+    }
+    if (node == 0) break;  // no crabs further down
+  }
+  return prefix;
+}
+
+std::int64_t OnlineAlignment::distances(std::int64_t x) const {
+  // crabs at x contribute nothing, so "left of x" can include them
+  const auto [count_below, sum_below] = below(x);
+  return (count_below * x - sum_below) +
+         ((total_sum_ - sum_below) - (total_count_ - count_below) * x);
+}
+
+void streamAlignment(std::ifstream& ifile, std::size_t report_every) {
+  OnlineAlignment alignment;
+  std::size_t num_updates = 0;
+  std::size_t num_reports = 0;
+  std::chrono::nanoseconds update_time{0};
+  std::chrono::nanoseconds query_time{0};
+
+  auto report = [&]() {
+    auto t_start = std::chrono::steady_clock::now();
+    auto [median, fuel_1] = alignment.absoluteAlignment();
+    auto [position_2, fuel_2] = alignment.triangularAlignment();
+    query_time += std::chrono::steady_clock::now() - t_start;
+    ++num_reports;
+
+    std::cout << "After " << num_updates << " updates (" << alignment.size()
+              << " crabs): part 1 at " << median << ", fuel " << fuel_1 << ", part 2 at "
+              << position_2 << ", fuel " << fuel_2 << std::endl;
+  };
+
+  std::string token;
+  while (ifile >> token) {
+    std::size_t begin = 0;
+    while (begin < token.size()) {
+      std::size_t end = token.find(',', begin);
+      if (end == std::string::npos) end = token.size();
+      if (end == begin) {
+        ++begin;
+        continue;
+      }
+
+      const bool removal = token[begin] == '-';
+      int position = std::stoi(token.substr(begin + removal, end - begin - removal));
+      begin = end + 1;
+
+      auto t_start = std::chrono::steady_clock::now();
+      if (removal) {
+        if (!alignment.remove(position)) {
+          std::cout << "Cannot remove " << position << ", no crab there" << std::endl;
+        }
+      } else {
+        alignment.insert(position);
+      }
+      update_time += std::chrono::steady_clock::now() - t_start;
+
+      ++num_updates;
+      if (report_every > 0 && num_updates % report_every == 0) report();
+    }
+  }
+  if (report_every == 0 || num_updates % report_every != 0) report();
+
+  std::cout << "Average update took "
+            << (num_updates > 0 ? update_time.count() / num_updates : 0) << " [ns]" << std::endl;
+  std::cout << "Average query took " << query_time.count() / num_reports << " [ns]" << std::endl;
+}
+
+}  // namespace
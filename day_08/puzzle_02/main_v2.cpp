@@ -0,0 +1,131 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * Signature version: no deduction chain, every digit is decoded with one table lookup.
+ *
+ * Each line shows all 10 digits once, so the number of patterns a segment appears in does
+ * not depend on the wiring:
+ *
+ *   segment    a  b  c  d  e  f  g   (of the real display)
+ *   frequency  8  6  8  7  4  9  7
+ *
+ * Summing the frequencies of the segments of a digit gives a signature that is different
+ * for all 10 digits:
+ *
+ *   digit      0   1   2   3   4   5   6   7   8   9
+ *   signature  42  17  34  39  30  37  41  25  49  45
+ *
+ * Per line, count how often each wire appears in the 10 patterns, then the signature of
+ * an output word is the sum of the counts of its wires, and SIGNATURE_DIGITS maps it to
+ * the digit. Apart from parsing, decoding has no branches.
+ *
+ */
+
+namespace {
+
+constexpr int NUM_SEGMENTS = 7;
+constexpr int MAX_SIGNATURE = 49;
+
+constexpr std::array<std::uint8_t, MAX_SIGNATURE + 1> makeSignatureDigits() {
+  constexpr std::array<int, 10> signatures = {42, 17, 34, 39, 30, 37, 41, 25, 49, 45};
+
+  std::array<std::uint8_t, MAX_SIGNATURE + 1> digits = {};
+  for (int digit = 0; digit < 10; ++digit) digits[signatures[digit]] = digit;
+  return digits;
+}
+
+constexpr std::array<std::uint8_t, MAX_SIGNATURE + 1> SIGNATURE_DIGITS = makeSignatureDigits();
+
+struct Display {
+  std::array<std::uint8_t, 10> patterns;  // one bit per wire, a = bit 0
+  std::array<std::uint8_t, 4> outputs;
+};
+
+// parse one line "patterns | outputs" starting at pos, returns the start of the next line
+const char* parseDisplay(const char* pos, const char* end, Display& display);
+
+// 4 digit output value
+int decodeDisplay(const Display& display);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <filename>" << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  std::ifstream ifile(filename);
+
+  if (!ifile.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  auto t_start = std::chrono::steady_clock::now();
+  ifile.seekg(0, std::ios::end);
+  std::string content(ifile.tellg(), '\0');
+  ifile.seekg(0);
+  ifile.read(content.data(), content.size());
+
+  std::size_t total_counter = 0;
+  const char* pos = content.data();
+  const char* end = content.data() + content.size();
+  Display display;
+  while ((pos = parseDisplay(pos, end, display)) != nullptr) {
+    total_counter += decodeDisplay(display);
+  }
+
+  auto t_end = std::chrono::steady_clock::now();
+
+  std::cout << "Got overall sum: " << total_counter << std::endl;
+  std::cout << "Execution took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()
+            << " us" << std::endl;
+
+  return 0;
+}
+
+namespace {
+
+const char* parseDisplay(const char* pos, const char* end, Display& display) {
+  std::uint8_t* words[14];
+  for (int i = 0; i < 10; ++i) words[i] = &display.patterns[i];
+  for (int i = 0; i < 4; ++i) words[10 + i] = &display.outputs[i];
+
+  for (int word = 0; word < 14; ++word) {
+    // skip separators (spaces, "|", new lines)
+    while (pos < end && (*pos < 'a' || *pos > 'z')) ++pos;
+    if (pos == end) return nullptr;  // incomplete line
+
+    std::uint8_t value = 0;
+    for (; pos < end && *pos >= 'a' && *pos <= 'z'; ++pos) value |= 1 << (*pos - 'a');
+    *words[word] = value;
+  }
+
+  return pos;
+}
+
+int decodeDisplay(const Display& display) {
+  std::array<std::uint8_t, NUM_SEGMENTS> frequencies = {};
+  for (auto pattern : display.patterns) {
+    for (int s = 0; s < NUM_SEGMENTS; ++s) frequencies[s] += (pattern >> s) & 1;
+  }
+
+  int value = 0;
+  for (auto output : display.outputs) {
+    int signature = 0;
+    for (int s = 0; s < NUM_SEGMENTS; ++s) signature += ((output >> s) & 1) * frequencies[s];
+    value = 10 * value + SIGNATURE_DIGITS[signature];
+  }
+  return value;
+}
+
+}  // namespace
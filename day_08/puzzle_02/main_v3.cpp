@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Batch version of the signature decoder (see main_v2), solving both parts.
+ *
+ * 1. Letters to segment bits: the low nibble of 'a' - 'g' is 1 - 7, of ' ', '|', '\n' and
+ *    '\r' it is 0, 12, 10 and 13. A 16 entry table indexed by the low nibble therefore gives
+ *    the segment bit of a letter and 0 for every separator. With AVX2 this is one shuffle
+ *    per 32 characters, and a compare + movemask gives a bitmap of the separators.
+ *
+ * 2. Words: a letter after a separator starts a word, a separator after a letter ends one.
+ *    Both are bitmaps derived from the separator bitmap with a shift, and are flattened to
+ *    positions with count-trailing-zeros. Letters of a word are distinct, so its mask is the
+ *    OR of at most 7 consecutive bytes, read as one 64 bit load and folded. Every 14 words
+ *    are one line (10 patterns, 4 outputs).
+ *
+ * 3. Lines: kept as a structure of arrays with one lane per line. Once LANES lines are
+ *    collected, wire frequencies, signatures and output word lengths are computed for all
+ *    lanes with byte loops that the compiler vectorizes (popcount as a sum of bits, the
+ *    signature as a masked sum of frequencies). Part 1 counts outputs with 2, 3, 4 or 7
+ *    segments, part 2 looks up the signature as in main_v2.
+ *
+ * The text is processed in blocks that end on a line boundary, so the scratch buffers stay
+ * small whatever the size of the input.
+ *
+ * Lines do not depend on each other, so the file is mapped into memory and split into
+ * chunks that also end on line boundaries, a few per thread (second argument, default: all
+ * cores). Each thread takes the next free chunk and keeps its own scratch buffers, batch
+ * and totals, which are added up once all chunks are done.
+ *
+ */
+
+namespace {
+
+constexpr int NUM_SEGMENTS = 7;
+constexpr int MAX_SIGNATURE = 49;
+constexpr int LANES = 32;
+constexpr std::size_t BLOCK_SIZE = 1 << 16;
+constexpr int CHUNKS_PER_THREAD = 8;
+
+constexpr std::array<std::uint8_t, MAX_SIGNATURE + 1> makeSignatureDigits() {
+  constexpr std::array<int, 10> signatures = {42, 17, 34, 39, 30, 37, 41, 25, 49, 45};
+
+  std::array<std::uint8_t, MAX_SIGNATURE + 1> digits = {};
+  for (int digit = 0; digit < 10; ++digit) digits[signatures[digit]] = digit;
+  return digits;
+}
+
+constexpr std::array<std::uint8_t, MAX_SIGNATURE + 1> SIGNATURE_DIGITS = makeSignatureDigits();
+
+// segment bit by low nibble of the character
+constexpr std::array<std::uint8_t, 16> NIBBLE_BITS = {0, 1, 2, 4, 8, 16, 32, 64,
+                                                      0, 0, 0, 0, 0,  0,  0,  0};
+
+struct Totals {
+  std::size_t unique_digits = 0;  // part 1
+  std::size_t output_sum = 0;     // part 2
+};
+
+// Lines as a structure of arrays, one lane per line
+class DisplayBatch {
+ public:
+  // append the next word of the current line, full batches are decoded into totals
+  void addWord(std::uint8_t mask, Totals& totals);
+
+  // decode the complete lines collected so far
+  void flush(Totals& totals);
+
+ private:
+  void decode(int num_lanes, Totals& totals);
+
+  std::array<std::array<std::uint8_t, LANES>, 10> patterns_ = {};
+  std::array<std::array<std::uint8_t, LANES>, 4> outputs_ = {};
+  int lane_ = 0;
+  int word_ = 0;
+};
+
+// Converts blocks of text to segment bits and splits them into words
+class BlockDecoder {
+ public:
+  // decode all words of [begin, end), which must end on a line boundary
+  void decode(const char* begin, const char* end, DisplayBatch& batch, Totals& totals);
+
+ private:
+  // fill bits_ and separators_ for size characters of text
+  void toSegmentBits(const char* text, std::size_t size);
+
+  // fill starts_ and ends_ from separators_, returns the number of words
+  std::size_t findWords();
+
+  std::vector<std::uint8_t> bits_;         // one per character, + 8 bytes padding
+  std::vector<std::uint64_t> separators_;  // bit set for separators and padding
+  std::vector<std::uint32_t> starts_;      // first letter of each word
+  std::vector<std::uint32_t> ends_;        // first separator after each word
+};
+
+// Read only mapping of a whole file
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool good() const { return good_; }
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+
+ private:
+  int fd_ = -1;
+  std::size_t size_ = 0;
+  const char* data_ = nullptr;
+  bool good_ = false;
+};
+
+// split [begin, end) into blocks ending on line boundaries and decode them
+void decodeChunk(const char* begin, const char* end, BlockDecoder& decoder, DisplayBatch& batch,
+                 Totals& totals);
+
+// split [begin, end) into chunks ending on line boundaries and decode them on num_threads
+Totals decodeText(const char* begin, const char* end, int num_threads);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Required input arguments: <filename> [num_threads]" << std::endl;
+    return 1;
+  }
+
+  std::string filename = argv[1];
+  int num_threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+  num_threads = std::max(num_threads, 1);
+
+  auto t_start = std::chrono::steady_clock::now();
+  MappedFile file(filename);
+
+  if (!file.good()) {
+    std::cout << "Could not open " << filename << std::endl;
+    return 1;
+  }
+
+  Totals totals = decodeText(file.begin(), file.end(), num_threads);
+  auto t_end = std::chrono::steady_clock::now();
+
+  std::cout << "Got unique digit count: " << totals.unique_digits << std::endl;
+  std::cout << "Got overall sum: " << totals.output_sum << std::endl;
+  std::cout << "Execution took "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()
+            << " us" << std::endl;
+
+  return 0;
+}
+
+namespace {
+
+void DisplayBatch::addWord(std::uint8_t mask, Totals& totals) {
+  if (word_ < 10) {
+    patterns_[word_][lane_] = mask;
+  } else {
+    outputs_[word_ - 10][lane_] = mask;
+  }
+
+  if (++word_ < 14) return;
+  word_ = 0;
+  if (++lane_ == LANES) {
+    decode(LANES, totals);
+    lane_ = 0;
+  }
+}
+
+void DisplayBatch::flush(Totals& totals) {
+  decode(lane_, totals);
+  lane_ = 0;
+  word_ = 0;  // drop an incomplete last line
+}
+
+void DisplayBatch::decode(int num_lanes, Totals& totals) {
+  // all loops over lanes have a fixed trip count and are vectorized, lanes past num_lanes
+  // hold stale lines and are ignored when summing up
+  std::array<std::array<std::uint8_t, LANES>, NUM_SEGMENTS> frequencies = {};
+  for (const auto& pattern : patterns_) {
+    for (int s = 0; s < NUM_SEGMENTS; ++s) {
+      for (int lane = 0; lane < LANES; ++lane) frequencies[s][lane] += (pattern[lane] >> s) & 1;
+    }
+  }
+
+  std::array<std::uint32_t, LANES> values = {};
+  for (const auto& output : outputs_) {
+    std::array<std::uint8_t, LANES> signatures = {};
+    std::array<std::uint8_t, LANES> lengths = {};
+    for (int s = 0; s < NUM_SEGMENTS; ++s) {
+      for (int lane = 0; lane < LANES; ++lane) {
+        std::uint8_t bit = (output[lane] >> s) & 1;
+        signatures[lane] += std::uint8_t(-bit) & frequencies[s][lane];
+        lengths[lane] += bit;
+      }
+    }
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+      std::uint8_t length = lengths[lane];
+      totals.unique_digits += (length == 2) | (length == 3) | (length == 4) | (length == 7);
+      values[lane] = 10 * values[lane] + SIGNATURE_DIGITS[signatures[lane]];
+    }
+  }
+
+  for (int lane = 0; lane < num_lanes; ++lane) totals.output_sum += values[lane];
+}
+
+void BlockDecoder::decode(const char* begin, const char* end, DisplayBatch& batch,
+                          Totals& totals) {
+  const std::size_t size = end - begin;
+  toSegmentBits(begin, size);
+
+  const std::size_t num_words = findWords();
+
+  for (std::size_t i = 0; i < num_words; ++i) {
+    const std::size_t length = ends_[i] - starts_[i];
+
+    // OR of the length bytes of the word
+    std::uint64_t word;
+    std::memcpy(&word, &bits_[starts_[i]], sizeof(word));
+    word &= length < 8 ? (std::uint64_t(1) << (8 * length)) - 1 : ~std::uint64_t(0);
+    word |= word >> 32;
+    word |= word >> 16;
+    word |= word >> 8;
+    batch.addWord(std::uint8_t(word), totals);
+  }
+}
+
+void BlockDecoder::toSegmentBits(const char* text, std::size_t size) {
+  bits_.assign(size + 8, 0);
+  separators_.assign(size / 64 + 2, ~std::uint64_t(0));
+
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i lut = _mm256_setr_epi8(0, 1, 2, 4, 8, 16, 32, 64, 0, 0, 0, 0, 0, 0, 0, 0,  //
+                                       0, 1, 2, 4, 8, 16, 32, 64, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  for (; i + 64 <= size; i += 64) {
+    std::uint64_t separators = 0;
+    for (int half = 0; half < 2; ++half) {
+      const std::size_t offset = i + 32 * half;
+      __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + offset));
+      __m256i bits = _mm256_shuffle_epi8(lut, _mm256_and_si256(chars, low_nibble));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(&bits_[offset]), bits);
+
+      std::uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, zero));
+      separators |= std::uint64_t(mask) << (32 * half);
+    }
+    separators_[i / 64] = separators;
+  }
+#endif
+
+  // remaining characters, blocks of 64 so every separator word is written once
+  for (; i < size; i += 64) {
+    std::uint64_t separators = ~std::uint64_t(0);  // past the end counts as separator
+    const std::size_t stop = std::min(i + 64, size);
+    for (std::size_t j = i; j < stop; ++j) {
+      bits_[j] = NIBBLE_BITS[text[j] & 0x0F];
+      separators &= ~(std::uint64_t(bits_[j] != 0) << (j - i));
+    }
+    separators_[i / 64] = separators;
+  }
+}
+
+std::size_t BlockDecoder::findWords() {
+  // at most one word per 2 characters
+  starts_.resize(32 * separators_.size());
+  ends_.resize(32 * separators_.size());
+
+  std::size_t num_starts = 0;
+  std::size_t num_ends = 0;
+  std::uint64_t carry = 1;  // the text starts after a separator
+  for (std::size_t index = 0; index < separators_.size(); ++index) {
+    const std::uint64_t separators = separators_[index];
+    const std::uint64_t previous = (separators << 1) | carry;  // separator before each char
+    carry = separators >> 63;
+
+    // padding ends the last word, so both lists have the same size
+    for (std::uint64_t starts = ~separators & previous; starts != 0; starts &= starts - 1) {
+      starts_[num_starts++] = 64 * index + __builtin_ctzll(starts);
+    }
+    for (std::uint64_t ends = separators & ~previous; ends != 0; ends &= ends - 1) {
+      ends_[num_ends++] = 64 * index + __builtin_ctzll(ends);
+    }
+  }
+
+  return num_starts;
+}
+
+MappedFile::MappedFile(const std::string& filename) {
+  fd_ = ::open(filename.c_str(), O_RDONLY);
+  struct stat status;
+  if (fd_ < 0 || ::fstat(fd_, &status) != 0) return;
+
+  size_ = status.st_size;
+  if (size_ == 0) {  // nothing to map
+    good_ = true;
+    return;
+  }
+
+  void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED) return;
+
+  ::madvise(data, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(data);
+  good_ = true;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+  if (fd_ >= 0) ::close(fd_);
+}
+
+void decodeChunk(const char* begin, const char* end, BlockDecoder& decoder, DisplayBatch& batch,
+                 Totals& totals) {
+  const char* block = begin;
+  while (block < end) {
+    const char* block_end = end;
+    if (std::size_t(end - block) > BLOCK_SIZE) {
+      // extend to the end of the line
+      const char* newline =
+          static_cast<const char*>(std::memchr(block + BLOCK_SIZE, '\n', end - block - BLOCK_SIZE));
+      block_end = newline ? newline + 1 : end;
+    }
+
+    decoder.decode(block, block_end, batch, totals);
+    block = block_end;
+  }
+}
+
+Totals decodeText(const char* begin, const char* end, int num_threads) {
+  // an empty file is not mapped, begin and end are null
+  if (begin == end) return {};
+
+  // chunk c starts after the first new line at or past c / num_chunks of the text
+  const int num_chunks = num_threads * CHUNKS_PER_THREAD;
+  const std::size_t size = end - begin;
+  std::vector<const char*> bounds(num_chunks + 1, end);
+  bounds[0] = begin;
+  for (int chunk = 1; chunk < num_chunks; ++chunk) {
+    const char* from = std::max(begin + size * chunk / num_chunks, bounds[chunk - 1]);
+    const char* newline = static_cast<const char*>(std::memchr(from, '\n', end - from));
+    bounds[chunk] = newline ? newline + 1 : end;
+  }
+
+  // one cache line per thread, so the totals never share one
+  struct alignas(64) Partial {
+    Totals totals;
+  };
+  std::vector<Partial> partials(num_threads);
+
+  std::atomic<int> next_chunk = 0;
+  auto worker = [&](int thread) {
+    BlockDecoder decoder;
+    DisplayBatch batch;
+    Totals& totals = partials[thread].totals;
+    for (int chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+      decodeChunk(bounds[chunk], bounds[chunk + 1], decoder, batch, totals);
+    }
+    batch.flush(totals);  // chunks end on line boundaries, so the batch holds whole lines
+  };
+
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < num_threads; ++thread) threads.emplace_back(worker, thread);
+  worker(0);
+  for (auto& thread : threads) thread.join();
+
+  Totals totals;
+  for (const auto& partial : partials) {
+    totals.unique_digits += partial.totals.unique_digits;
+    totals.output_sum += partial.totals.output_sum;
+  }
+  return totals;
+}
+
+}  // namespace